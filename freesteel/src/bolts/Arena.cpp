@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////////////////////////
+// FreeSteel -- Computer Aided Manufacture Algorithms
+// Copyright (C) 2004  Julian Todd and Martin Dunschen.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// See fslicense.txt and gpl.txt for further details
+////////////////////////////////////////////////////////////////////////////////
+#include "bolts/Arena.h"
+#include "bolts/debugfuncs.h"
+#include <atomic>
+
+//////////////////////////////////////////////////////////////////////
+// smallest class holds a free list pointer and keeps blocks aligned
+static const std::size_t minblock = 16;
+
+static std::size_t SizeClass(std::size_t nbytes)
+{
+    std::size_t ic = 0;
+    while ((minblock << ic) < nbytes)
+        ic++;
+    return ic;
+}
+
+//////////////////////////////////////////////////////////////////////
+// threads are dealt out to the shards in turn as they first allocate.  
+static std::size_t ThreadShard(std::size_t nshards)
+{
+    static std::atomic<std::size_t> nthreads(0);
+    static thread_local std::size_t ishard = nthreads++;
+    return ishard % nshards;
+}
+
+//////////////////////////////////////////////////////////////////////
+Arena::Arena(std::size_t lchunksize)
+ : mtx(), chunks(), bigblocks(), chunksize(lchunksize), chunkused(lchunksize), nreserved(0)
+{
+    for (auto& sh : shards)
+    {
+        for (auto& fl : sh.freelists)
+            fl = nullptr;
+        sh.slab = nullptr;
+        sh.slableft = 0;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+// a slab for a shard, or a block too big for one.  
+void* Arena::AllocateSlab(std::size_t nbytes)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    // blocks bigger than a chunk get one of their own
+    if (nbytes > chunksize)
+    {
+        bigblocks.emplace_back(new char[nbytes]);
+        nreserved += nbytes;
+        return bigblocks.back().get();
+    }
+
+    // the tail of a used up chunk is wasted
+    if (chunkused + nbytes > chunksize)
+    {
+        chunks.emplace_back(new char[chunksize]);
+        nreserved += chunksize;
+        chunkused = 0;
+    }
+    void* p = chunks.back().get() + chunkused;
+    chunkused += nbytes;
+    return p;
+}
+
+//////////////////////////////////////////////////////////////////////
+void* Arena::Allocate(std::size_t nbytes)
+{
+    std::size_t ic = SizeClass(nbytes);
+    ASSERT(ic < nclasses);
+    std::size_t blocksize = (minblock << ic);
+
+    Shard& sh = shards[ThreadShard(nshards)];
+    std::lock_guard<std::mutex> lock(sh.mtx);
+    if (sh.freelists[ic] != nullptr)
+    {
+        void* p = sh.freelists[ic];
+        sh.freelists[ic] = *static_cast<void**>(p);
+        return p;
+    }
+
+    std::size_t slabsize = chunksize / nshards;
+    if (blocksize > slabsize)
+        return AllocateSlab(blocksize);
+
+    // the tail of a used up slab is wasted
+    if (sh.slableft < blocksize)
+    {
+        sh.slab = static_cast<char*>(AllocateSlab(slabsize));
+        sh.slableft = slabsize;
+    }
+    void* p = sh.slab;
+    sh.slab += blocksize;
+    sh.slableft -= blocksize;
+    return p;
+}
+
+//////////////////////////////////////////////////////////////////////
+void Arena::Deallocate(void* p, std::size_t nbytes)
+{
+    std::size_t ic = SizeClass(nbytes);
+    Shard& sh = shards[ThreadShard(nshards)];
+    std::lock_guard<std::mutex> lock(sh.mtx);
+    *static_cast<void**>(p) = sh.freelists[ic];
+    sh.freelists[ic] = p;
+}
+
+//////////////////////////////////////////////////////////////////////
+// not while other threads are allocating.  
+void Arena::Reset()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    chunks.clear();
+    bigblocks.clear();
+    chunkused = chunksize;
+    nreserved = 0;
+    for (auto& sh : shards)
+    {
+        for (auto& fl : sh.freelists)
+            fl = nullptr;
+        sh.slab = nullptr;
+        sh.slableft = 0;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+std::size_t Arena::BytesReserved()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return nreserved;
+}
@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+// FreeSteel -- Computer Aided Manufacture Algorithms
+// Copyright (C) 2004  Julian Todd and Martin Dunschen.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// See fslicense.txt and gpl.txt for further details
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef Arena__h
+#define Arena__h
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////
+// blocks cut from large chunks, in power of two size classes with 
+// a free list for each, so that growing vectors reuse the space 
+// given back by one another.  The chunks are only released all 
+// together by Reset or the destructor, which must come after 
+// everything allocated from here has gone.  
+// The fibres are hacked on several threads, so the free lists and 
+// a slab to cut new blocks from are kept in shards, a thread to each, 
+// with mtx only taken to hand a shard a new slab.  A block freed on 
+// another thread goes to that thread's shard.  
+class Arena
+{
+    std::mutex mtx;
+    std::vector< std::unique_ptr<char[]> > chunks;
+    std::vector< std::unique_ptr<char[]> > bigblocks; // those bigger than a chunk
+    std::size_t chunksize;
+    std::size_t chunkused; // in the last chunk
+    std::size_t nreserved;
+
+    static const std::size_t nclasses = 48;
+    static const std::size_t nshards = 16;
+    struct Shard
+    {
+        std::mutex mtx;
+        void* freelists[nclasses];
+        char* slab;
+        std::size_t slableft;
+    };
+    Shard shards[nshards];
+
+    void* AllocateSlab(std::size_t nbytes);
+
+public:
+    Arena(std::size_t lchunksize = (1 << 20));
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* Allocate(std::size_t nbytes);
+    void Deallocate(void* p, std::size_t nbytes);
+    void Reset();
+
+    std::size_t BytesReserved();
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// for standard containers.  with no arena it goes to the heap.  
+template<class T>
+struct ArenaAllocator
+{
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    Arena* parena;
+
+    ArenaAllocator(Arena* lparena = nullptr) : parena(lparena) {;}
+    template<class U> ArenaAllocator(const ArenaAllocator<U>& a) : parena(a.parena) {;}
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(parena != nullptr ? parena->Allocate(n * sizeof(T)) : ::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, std::size_t n)
+    {
+        if (parena != nullptr)
+            parena->Deallocate(p, n * sizeof(T));
+        else
+            ::operator delete(p);
+    }
+};
+
+template<class T, class U>
+inline bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+    { return a.parena == b.parena; }
+template<class T, class U>
+inline bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+    { return a.parena != b.parena; }
+
+#endif
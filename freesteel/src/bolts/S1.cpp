@@ -103,27 +103,29 @@ void S1::Merge(double rglo, bool binterncellboundlo, double rghi, bool binternce
 	{
         if (ep[il].blower)
 		{
-            ep.insert(ep.begin() + il, 2, B1(rghi, false, binterncellboundhi));
-            ep[il] = B1(rglo, true, binterncellboundlo);
+            auto& mep = ep.Mutable();
+            mep.insert(mep.begin() + il, 2, B1(rghi, false, binterncellboundhi));
+            mep[il] = B1(rglo, true, binterncellboundlo);
 			ASSERT(Check()); 
 		}
 		return; 
 	}
 
 	// we have il to ir inclusive within the range 
-    if (!ep[ir].blower)
+    auto& mep = ep.Mutable();
+    if (!mep[ir].blower)
 	{
-        ep[ir] = B1(rghi, false, binterncellboundhi);
+        mep[ir] = B1(rghi, false, binterncellboundhi);
 		ir--; 
 	}
-    if (ep[il].blower)
+    if (mep[il].blower)
 	{
-        ep[il] = B1(rglo, true, binterncellboundlo);
+        mep[il] = B1(rglo, true, binterncellboundlo);
 		il++; 
 	}
 
 	if (il <= ir) 
-        ep.erase(ep.begin() + il, ep.begin() + ir + 1);
+        mep.erase(mep.begin() + il, mep.begin() + ir + 1);
 	ASSERT(Check()); 
 }
 
@@ -142,48 +144,67 @@ void S1::Minus(double rglo, bool binterncellboundlo, double rghi, bool binternce
         if (ep[il].blower)
 			return;
 
-        ep.emplace(ep.begin() + il, rghi, true, binterncellboundhi);
-        ep.emplace(ep.begin() + il, rglo, false, binterncellboundlo);
+        auto& mep = ep.Mutable();
+        mep.emplace(mep.begin() + il, rghi, true, binterncellboundhi);
+        mep.emplace(mep.begin() + il, rglo, false, binterncellboundlo);
 		ASSERT(Check()); 
 		return; 
 	}
 
 	// we have il to ir inclusive within the range 
-    if (!ep[il].blower)
+    auto& mep = ep.Mutable();
+    if (!mep[il].blower)
 	{
-        ep[il] = B1(rglo, false, binterncellboundlo);
+        mep[il] = B1(rglo, false, binterncellboundlo);
 		++il;
 	}
-    if (ep[ir].blower)
+    if (mep[ir].blower)
 	{
-        ep[ir] = B1(rghi, true, binterncellboundlo);
+        mep[ir] = B1(rghi, true, binterncellboundlo);
 		--ir;
 	}
 
 	if (il <= ir) 
-        ep.erase(ep.begin() + il, ep.begin() + ir + 1);
+        mep.erase(mep.begin() + il, mep.begin() + ir + 1);
 	ASSERT(Check()); 
 }
 
 
+//////////////////////////////////////////////////////////////////////
+// the first interval whose top reaches lw is the only one which can contain it.  
+std::ptrdiff_t S1::ContainsIndex(double lw) const 
+{
+    std::size_t klo = 0; 
+    std::size_t khi = ep.size() / 2; 
+    while (klo < khi)
+    {
+        std::size_t kmid = (klo + khi) / 2; 
+        if (ep[2 * kmid + 1].w >= lw)
+            khi = kmid; 
+        else
+            klo = kmid + 1; 
+    }
+
+    if ((2 * klo + 1 < ep.size()) && (ep[2 * klo].w <= lw))
+        return 2 * klo; 
+    return -1; 
+}
+
 //////////////////////////////////////////////////////////////////////
 bool S1::Contains(double lw) const 
 {
-    for (std::size_t i = 1; i < ep.size(); i += 2)
-        if ((ep[i - 1].w <= lw) && (ep[i].w >= lw))
-			return true; 
-	return false; 
+	return (ContainsIndex(lw) != -1); 
 }
 
 //////////////////////////////////////////////////////////////////////
 I1 S1::ContainsRG(double lw) const 
 {
-    for (std::size_t i = 1; i < ep.size(); i += 2)
-        if ((ep[i - 1].w <= lw) && (ep[i].w >= lw))
-            return I1(ep[i - 1].w, ep[i].w);
+    std::ptrdiff_t i = ContainsIndex(lw); 
+    if (i != -1)
+        return I1(ep[i].w, ep[i + 1].w);
 
-	ASSERT(0); 
-	return I1unit; 
+    ASSERT(0); 
+    return I1unit; 
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -198,32 +219,26 @@ void S1::Invert()
 	}
 
 	// invert the flags 
-    for (auto& p : ep) p.blower = !p.blower;
+    auto& mep = ep.Mutable();
+    for (auto& p : mep) p.blower = !p.blower;
 
 	// the front condition  
-    if (ep.front().w == wrg.lo)
+    if (mep.front().w == wrg.lo)
 	{
-        ASSERT(!ep.front().blower);
-        ep.erase(ep.begin());
+        ASSERT(!mep.front().blower);
+        mep.erase(mep.begin());
 	}
 	else
-        ep.emplace(ep.begin(), wrg.lo, true);
+        mep.emplace(mep.begin(), wrg.lo, true);
 
 	// the back condition 
-    if (ep.back().w == wrg.hi)
+    if (mep.back().w == wrg.hi)
 	{
-        ASSERT(ep.back().blower);
-        ep.pop_back();
+        ASSERT(mep.back().blower);
+        mep.pop_back();
 	}
 	else
-        ep.emplace_back(wrg.hi, false);
+        mep.emplace_back(wrg.hi, false);
 
 	ASSERT(Check()); 
 }
-
-//////////////////////////////////////////////////////////////////////
-void S1::SetAllCutCodes(int lcutcode)
-{
-    for(auto& e : ep)
-        e.cutcode = lcutcode;
-}
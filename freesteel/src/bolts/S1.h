@@ -21,34 +21,106 @@
 
 #ifndef S1_H
 #define S1_H
+#include <algorithm>
+#include <memory>
 #include <vector>
 #include <utility>
 #include "I1.h"
+#include "Arena.h"
 
 //////////////////////////////////////////////////////////////////////
 // an endpoint in the fibre.  
+// only the position and flags live here, so the slicing 
+// works over a dense array.  
 struct B1
 {
     double w;
 
     bool blower;
     bool binterncellbound;
-    int contournumber;
-
-    int cutcode;
 
     B1(double lw, bool lblower, bool lbinterncellbound = false)
-        : w(lw), blower(lblower), binterncellbound(lbinterncellbound), contournumber(-1), cutcode()
+        : w(lw), blower(lblower), binterncellbound(lbinterncellbound)
     {}
 
     bool operator<(const B1& b) const { return w < b.w; }
 }; 
 
+//////////////////////////////////////////////////////////////////////
+// the contouring and cutting bookkeeping of an endpoint.  
+// kept in a side array parallel to the endpoints (see S2weave), 
+// which is only made once contouring starts.  
+struct B1c
+{
+    int contournumber;
+    int cutcode; // the S2weave cutepoch it was cut in
+
+    B1c()
+        : contournumber(-1), cutcode(-1)
+    {}
+}; 
+
+//////////////////////////////////////////////////////////////////////
+// the endpoints of a fibre, shared between copies of the fibre until 
+// one of them changes them.  so a copy of a weave is a snapshot which 
+// only costs a fibre each time a fibre is hacked after it.  
+// reads are through the const functions; changes go through Mutable, 
+// which takes a private copy first if the endpoints are shared, 
+// and counts the writes so caches of pointers into them can tell.  
+class B1cow
+{
+public:
+    typedef std::vector< B1, ArenaAllocator<B1> > B1vec;
+    typedef B1vec::const_iterator const_iterator;
+
+    explicit B1cow(Arena* parena = nullptr)
+        : pv(std::allocate_shared<B1vec>(ArenaAllocator<B1vec>(parena), ArenaAllocator<B1>(parena))), nwrites(0)
+    {}
+
+    // no moves, which would leave the pointer null.  
+    // an assignment is a write, so the count never comes back round.  
+    B1cow(const B1cow& b) : pv(b.pv), nwrites(b.nwrites) {}
+    B1cow& operator=(const B1cow& b) { pv = b.pv; nwrites = std::max(nwrites, b.nwrites) + 1; return *this; }
+
+    std::size_t size() const { return pv->size(); }
+    bool empty() const { return pv->empty(); }
+    const B1& operator[](std::size_t i) const { return (*pv)[i]; }
+    const B1& front() const { return pv->front(); }
+    const B1& back() const { return pv->back(); }
+    const B1* data() const { return pv->data(); }
+    const_iterator begin() const { return pv->cbegin(); }
+    const_iterator end() const { return pv->cend(); }
+    bool bshared() const { return (pv.use_count() != 1); }
+    std::size_t Nwrites() const { return nwrites; }
+
+    B1vec& Mutable()
+    {
+        nwrites++;
+        if (bshared())
+            pv = std::allocate_shared<B1vec>(ArenaAllocator<B1vec>(pv->get_allocator()), *pv);
+        return *pv;
+    }
+    void clear()
+    {
+        nwrites++;
+        if (bshared())
+            pv = std::allocate_shared<B1vec>(ArenaAllocator<B1vec>(pv->get_allocator()), pv->get_allocator());
+        else
+            pv->clear();
+    }
+    template<class... Args> void emplace_back(Args&&... args)
+        { Mutable().emplace_back(std::forward<Args>(args)...); }
+
+private:
+    std::shared_ptr<B1vec> pv;
+    std::size_t nwrites;
+};
+
 //////////////////////////////////////////////////////////////////////
 // this is a fibre 
 struct S1
 {
-    std::vector<B1> ep;
+    B1cow ep; // from the heap unless given an arena
     double wp; // the perpendicular position.
     I1 wrg;
 
@@ -74,6 +146,7 @@ struct S1
 
     bool Contains(double lw) const;
     I1 ContainsRG(double lw) const;
+    std::ptrdiff_t ContainsIndex(double lw) const; // index of the lower endpoint, or -1
 
     void SetNew(double lwp, const I1& lwrg, Fibre lftype)
     {
@@ -86,11 +159,9 @@ struct S1
     S1()
         : ep(), wp(), wrg(I1unit), ftype()
     {}
-    S1(double lwp, I1& lwrg, Fibre lftype)
-        : ep(), wp(lwp), wrg(lwrg), ftype(lftype)
+    S1(double lwp, const I1& lwrg, Fibre lftype, Arena* parena = nullptr)
+        : ep(parena), wp(lwp), wrg(lwrg), ftype(lftype)
     {}
-
-    void SetAllCutCodes(int lcutcode);
 }; 
 
 
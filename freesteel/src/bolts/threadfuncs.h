@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+// FreeSteel -- Computer Aided Manufacture Algorithms
+// Copyright (C) 2004  Julian Todd and Martin Dunschen.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// See fslicense.txt and gpl.txt for further details
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef threadfuncs__h
+#define threadfuncs__h
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////
+// set on the threads working through a ParallelFor.  
+inline bool& InParallelFor()
+{
+    static thread_local bool binside = false;
+    return binside;
+}
+
+//////////////////////////////////////////////////////////////////////
+// runs f(i0, i1) over chunks [i0, i1) covering [0, n) on all the cores.  
+// the chunks are handed out from a shared counter, so threads which 
+// land in sparse parts of the range steal on through the rest of it 
+// rather than idling while a dense part finishes.  
+// f must only write to state belonging to its own indexes.  
+// calls from inside f run on their own thread, as the cores are taken.  
+template<class F>
+void ParallelFor(std::size_t n, std::size_t chunk, F f)
+{
+    std::size_t nchunks = (n + chunk - 1) / chunk;
+    std::size_t nthreads = std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), nchunks);
+    if ((nthreads <= 1) || InParallelFor())
+    {
+        if (n != 0)
+            f(std::size_t(0), n);
+        return;
+    }
+
+    std::atomic<std::size_t> inext(0);
+    auto work = [&]()
+    {
+        InParallelFor() = true;
+        while (true)
+        {
+            std::size_t i0 = inext.fetch_add(chunk);
+            if (i0 >= n)
+                break;
+            f(i0, std::min(i0 + chunk, n));
+        }
+        InParallelFor() = false;
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t k = 1; k < nthreads; k++)
+        threads.emplace_back(work);
+    work();
+    for (auto& th : threads)
+        th.join();
+}
+
+#endif
@@ -21,22 +21,46 @@
 #include "cages/Area2_gen.h"
 #include "pits/NormRay_gen.h"
 #include "cages/Ray_gen2.h"
+#include "cages/DistanceField.h"
+#include "bolts/threadfuncs.h"
+#include "bolts/smallfuncs.h"
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <limits>
+#include <tuple>
 
-Area2_gen::Area2_gen(const I1& urg, const I1& vrg, double res)
- : S2weave(urg, vrg, res), psxb(), z(), r()
+Area2_gen::Area2_gen(const I1& urg, const I1& vrg, double res, Arena* lparena)
+ : S2weave(urg, vrg, res, lparena), psxb(), z(), r(), ufibzs(), vfibzs(), zsweepband(), zhist()
 {
 }
 
-Area2_gen::Area2_gen(const I1& urg, const I1& vrg, double res, SurfXboxed* lpsxb, double lr)
- : S2weave(urg, vrg, res), psxb(lpsxb), z(psxb->psurfx->gzrg.hi), r(lr)
+Area2_gen::Area2_gen(const I1& urg, const I1& vrg, double res, SurfXboxed* lpsxb, double lr, Arena* lparena)
+ : S2weave(urg, vrg, res, lparena), psxb(lpsxb), z(psxb->psurfx->gzrg.hi), r(lr), ufibzs(), vfibzs(), zsweepband(), zhist()
 {
 }
 
+Area2_gen::Area2_gen(const S2weave& wve)
+ : S2weave(wve), psxb(), z(), r(), ufibzs(), vfibzs(), zsweepband(), zhist()
+{
+}
+
+//////////////////////////////////////////////////////////////////////
+Area2_gen Area2_gen::Snapshot() const
+{
+    Area2_gen res(static_cast<const S2weave&>(*this));
+    res.psxb = psxb;
+    res.z = z;
+    res.r = r;
+    return res;
+}
+
 //////////////////////////////////////////////////////////////////////
 void Area2_gen::FindInterior(SurfX& sx)
 {
     SLi_gen sgen;
     std::vector<I1> res;
+    Changed();
 
     for (auto& ufib : ufibs)
     {
@@ -65,92 +89,546 @@ void Area2_gen::FindInterior(SurfX& sx)
     }
 }
 
+//////////////////////////////////////////////////////////////////////
+void Area2_gen::BuildZsweep(double lzsweepband)
+{
+    // the lists are filled in band by band as the levels come down.  
+    zsweepband = lzsweepband;
+    ufibzs.resize(ufibs.size());
+    vfibzs.resize(vfibs.size());
+}
+
 //////////////////////////////////////////////////////////////////////
 void Area2_gen::HackDowntoZ(float lz)
 {
     ASSERT(lz <= z);
     z = lz;
+    zhist.push_back(z);
+    Changed();
 
-    Ray_gen uryg(r, vrg);
-    for (auto& ufib : ufibs)
+    // only the elements whose z-range we have moved into need be looked at.  
+    if (!ufibzs.empty() || !vfibzs.empty())
     {
-        uryg.HoldFibre(&ufib, z);
-        psxb->SliceUFibre(uryg);
+        ASSERT((ufibzs.size() == ufibs.size()) && (vfibzs.size() == vfibs.size()));
+        ParallelFor(ufibs.size(), 8, [this](std::size_t i0, std::size_t i1)
+        {
+            Ray_gen uryg(r, vrg);
+            for (std::size_t i = i0; i < i1; i++)
+            {
+                uryg.HoldFibre(&ufibs[i], z);
+                ufibzs[i].SliceDowntoZ(uryg, *psxb, zsweepband);
+            }
+        });
+
+        ParallelFor(vfibs.size(), 8, [this](std::size_t i0, std::size_t i1)
+        {
+            Ray_gen vryg(r, urg);
+            for (std::size_t i = i0; i < i1; i++)
+            {
+                vryg.HoldFibre(&vfibs[i], z);
+                vfibzs[i].SliceDowntoZ(vryg, *psxb, zsweepband);
+            }
+        });
+        return;
     }
 
-    Ray_gen vryg(r, urg);
-    for (auto& vfib : vfibs)
+    // each fibre writes only to itself and the boxed surface is not changed, 
+    // so the fibres can be sliced on separate threads.  
+    ParallelFor(ufibs.size(), 8, [this](std::size_t i0, std::size_t i1)
     {
-        vryg.HoldFibre(&vfib, z);
-        psxb->SliceVFibre(vryg);
+        Ray_gen uryg(r, vrg);
+        for (std::size_t i = i0; i < i1; i++)
+        {
+            uryg.HoldFibre(&ufibs[i], z);
+            psxb->SliceUFibre(uryg);
+        }
+    });
+
+    ParallelFor(vfibs.size(), 8, [this](std::size_t i0, std::size_t i1)
+    {
+        Ray_gen vryg(r, urg);
+        for (std::size_t i = i0; i < i1; i++)
+        {
+            vryg.HoldFibre(&vfibs[i], z);
+            psxb->SliceVFibre(vryg);
+        }
+    });
+}
+
+
+//////////////////////////////////////////////////////////////////////
+void Area2_gen::HackDowntoZ(const std::vector<Area2_gen*>& a2gs, float lz)
+{
+    if (a2gs.empty())
+        return;
+
+    // the generators take the radii in decreasing order
+    std::vector<Area2_gen*> sa2gs = a2gs;
+    std::stable_sort(sa2gs.begin(), sa2gs.end(), [](const Area2_gen* a, const Area2_gen* b) { return a->r > b->r; });
+
+    std::vector<double> radballs;
+    for (auto pa2g : sa2gs)
+    {
+        ASSERT(lz <= pa2g->z);
+        ASSERT((pa2g->psxb == sa2gs[0]->psxb) && (pa2g->ufibs.size() == sa2gs[0]->ufibs.size()) && (pa2g->vfibs.size() == sa2gs[0]->vfibs.size()));
+        pa2g->z = lz;
+        pa2g->zhist.push_back(pa2g->z);
+        pa2g->Changed();
+        radballs.push_back(pa2g->r);
     }
+
+    SurfXboxed* psxb = sa2gs[0]->psxb;
+    const Area2_gen& a2g0 = *sa2gs[0];
+
+    ParallelFor(a2g0.ufibs.size(), 8, [&](std::size_t i0, std::size_t i1)
+    {
+        MultiRay_gen uryg(radballs, a2g0.vrg);
+        std::vector<S1*> pfibs(sa2gs.size());
+        for (std::size_t i = i0; i < i1; i++)
+        {
+            for (std::size_t k = 0; k < sa2gs.size(); k++)
+                pfibs[k] = &sa2gs[k]->ufibs[i];
+            uryg.HoldFibres(pfibs, lz);
+            psxb->SliceFibre(uryg);
+        }
+    });
+
+    ParallelFor(a2g0.vfibs.size(), 8, [&](std::size_t i0, std::size_t i1)
+    {
+        MultiRay_gen vryg(radballs, a2g0.urg);
+        std::vector<S1*> pfibs(sa2gs.size());
+        for (std::size_t i = i0; i < i1; i++)
+        {
+            for (std::size_t k = 0; k < sa2gs.size(); k++)
+                pfibs[k] = &sa2gs[k]->vfibs[i];
+            vryg.HoldFibres(pfibs, lz);
+            psxb->SliceFibre(vryg);
+        }
+    });
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// the endpoints numbered in one flat sequence, u fibres first.  
+static std::vector<std::size_t> EndpointOffsets(const std::vector<S1>& wfibs, std::size_t ioff)
+{
+    std::vector<std::size_t> offs;
+    offs.reserve(wfibs.size() + 1);
+    offs.push_back(ioff);
+    for (auto& fib : wfibs)
+        offs.push_back(offs.back() + fib.ep.size());
+    return offs;
 }
 
+static std::pair<std::size_t, std::size_t> FindEndpoint(const std::vector<std::size_t>& offs, std::size_t ie)
+{
+    std::size_t ixwp = std::upper_bound(offs.begin(), offs.end(), ie) - offs.begin() - 1;
+    return std::make_pair(ixwp, ie - offs[ixwp]);
+}
 
 //////////////////////////////////////////////////////////////////////
-void Area2_gen::MakeContours(PathXSeries& ftpaths)
+// Douglas-Peucker.  the contours are closed, so the first span has the 
+// same point at both ends and splits at the point furthest from it.  
+static void SimplifyContour(std::vector<P2>& pth, double simptol)
+{
+    if (pth.size() <= 2)
+        return;
+
+    std::vector<char> bkeep(pth.size(), 0);
+    bkeep.front() = 1;
+    bkeep.back() = 1;
+
+    std::vector< std::pair<std::size_t, std::size_t> > spans;
+    spans.emplace_back(0, pth.size() - 1);
+    while (!spans.empty())
+    {
+        std::size_t i0 = spans.back().first;
+        std::size_t i1 = spans.back().second;
+        spans.pop_back();
+
+        P2 v = pth[i1] - pth[i0];
+        double vlen = v.Len();
+        double dmax = -1.0;
+        std::size_t imax = i0;
+        for (std::size_t i = i0 + 1; i < i1; i++)
+        {
+            P2 d = pth[i] - pth[i0];
+            double dist = (vlen != 0.0 ? fabs(Dot(d, APerp(v))) / vlen : d.Len());
+            if (dist > dmax)
+            {
+                dmax = dist;
+                imax = i;
+            }
+        }
+
+        if ((dmax > simptol) || ((vlen == 0.0) && (imax != i0)))
+        {
+            bkeep[imax] = 1;
+            if (imax - i0 >= 2)
+                spans.emplace_back(i0, imax);
+            if (i1 - imax >= 2)
+                spans.emplace_back(imax, i1);
+        }
+    }
+
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < pth.size(); i++)
+        if (bkeep[i])
+            pth[j++] = pth[i];
+    pth.resize(j);
+}
+
+//////////////////////////////////////////////////////////////////////
+// a contour traced from one seed.  it only counts if the seed ends up 
+// owning its endpoints, meaning it came first in the scan order.  
+struct SeedContour
+{
+    std::vector<P2> pth;
+    std::vector<std::size_t> eps;
+};
+
+//////////////////////////////////////////////////////////////////////
+// The seeds are the u endpoints in the order the plain scan through 
+// the fibres meets them, and each thread traces from its seeds claiming 
+// every endpoint for the lowest seed to reach it.  A seed which runs into 
+// an endpoint claimed by a lower one drops out, since that one will trace 
+// the same contour.  The survivors are exactly the contours the scan 
+// would have started, from the same endpoints, and are numbered and output 
+// in seed order.  
+void Area2_gen::MakeContours(PathXSeries& ftpaths, double simptol)
 {
     firstcontournumber = lastcontournumber + 1;
 
-    S2weaveB1iter alscan;
-    alscan.ftype = S2weaveB1iter::Fibre::u;
-    for (alscan.ixwp = 0; alscan.ixwp < ufibs.size(); alscan.ixwp++)
+    std::vector<std::size_t> uoffs = EndpointOffsets(ufibs, 0);
+    std::vector<std::size_t> voffs = EndpointOffsets(vfibs, uoffs.back());
+    std::size_t nseeds = uoffs.back();
+    std::size_t nendpoints = voffs.back();
+
+    const std::size_t nowner = std::numeric_limits<std::size_t>::max();
+    std::vector< std::atomic<std::size_t> > owners(nendpoints);
+    for (auto& owner : owners)
+        owner.store(nowner, std::memory_order_relaxed);
+    std::vector<SeedContour> seedcontours(nseeds);
+
+    ParallelFor(nseeds, 64, [&](std::size_t i0, std::size_t i1)
     {
-        alscan.wp = ufibs[alscan.ixwp].wp;
-        for (std::size_t i = 0; i < ufibs[alscan.ixwp].ep.size(); i++)
+        for (std::size_t is = i0; is < i1; is++)
         {
-            alscan.w = ufibs[alscan.ixwp].ep[i].w;
-            alscan.blower = ufibs[alscan.ixwp].ep[i].blower;
+            if (owners[is].load() < is)
+                continue;
+
+            S2weaveB1iter al;
+            al.ftype = S2weaveB1iter::Fibre::u;
+            std::tie(al.ixwp, al.iep) = FindEndpoint(uoffs, is);
+            al.wp = ufibs[al.ixwp].wp;
+            al.w = ufibs[al.ixwp].ep[al.iep].w;
+            al.blower = ufibs[al.ixwp].ep[al.iep].blower;
 
-            if (ContourNumber(alscan) < firstcontournumber)
+            SeedContour& sc = seedcontours[is];
+            while (true)
             {
-                std::vector<P2> contour;
-                TrackContour(contour, alscan);
-                ftpaths.Append(contour);
-                ftpaths.z = z;
+                std::size_t ie = (al.ftype == S2weaveB1iter::Fibre::u ? uoffs : voffs)[al.ixwp] + al.iep;
+                std::size_t iprev = owners[ie].load();
+                while ((iprev > is) && !owners[ie].compare_exchange_weak(iprev, is))
+                    ;
+
+                if (iprev < is)
+                {
+                    sc.pth.clear();
+                    sc.eps.clear();
+                    break;
+                }
+
+                sc.pth.push_back(al.GetPoint());
+                if (iprev == is)
+                    break; // back round to the start
+                sc.eps.push_back(ie);
+                Advance(al);
             }
         }
+    });
+
+    std::vector<std::size_t> iscontours;
+    for (std::size_t is = 0; is < nseeds; is++)
+    {
+        SeedContour& sc = seedcontours[is];
+        if (sc.eps.empty() || (owners[is].load() != is))
+            continue;
+
+        lastcontournumber++;
+        for (auto ie : sc.eps)
+        {
+            bool bufib = (ie < nseeds);
+            auto ixwpiep = FindEndpoint((bufib ? uoffs : voffs), ie);
+            GetB1c(bufib, ixwpiep.first, ixwpiep.second).contournumber = lastcontournumber;
+        }
+        iscontours.push_back(is);
+    }
+
+    // the weave keeps its numbering on every crossing; only the paths are thinned.  
+    if (simptol > 0.0)
+    {
+        ParallelFor(iscontours.size(), 16, [&](std::size_t i0, std::size_t i1)
+        {
+            for (std::size_t ic = i0; ic < i1; ic++)
+                SimplifyContour(seedcontours[iscontours[ic]].pth, simptol);
+        });
+    }
+
+    for (auto is : iscontours)
+    {
+        ftpaths.Append(seedcontours[is].pth);
+        ftpaths.z = z;
     }
 }
 
 
 //////////////////////////////////////////////////////////////////////
-void HackToolpath(S2weave& wve, const PathXSeries& pathxs, std::size_t iseg, const P2& ptpath, double rad)
+// slice a fibre which wasn't there before down through all the levels so far
+void Area2_gen::SliceNewFibre(S1& fib, FibreZsweep& fzs)
+{
+    bool bzsweep = !ufibzs.empty();
+    Ray_gen rgen(r, fib.wrg);
+    for (auto hz : zhist)
+    {
+        rgen.HoldFibre(&fib, hz);
+        if (bzsweep)
+            fzs.SliceDowntoZ(rgen, *psxb, zsweepband);
+        else if (fib.ftype == S1::Fibre::u)
+            psxb->SliceUFibre(rgen);
+        else
+            psxb->SliceVFibre(rgen);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+// a strip is between fibres i - 1 and i.  we slice a trial fibre down 
+// its middle and keep it if its endpoints aren't where the contours 
+// already cross that line.  
+std::size_t Area2_gen::RefineStrips(bool bufib, const PathXSeries& cpaths, double tol, double resmin)
 {
-    Ray_gen2 ryg2(rad);
+    std::vector<S1>& wfibs = (bufib ? ufibs : vfibs);
+    auto wpof = [bufib](const P2& p) { return (bufib ? p.u : p.v); };
+    auto wof = [bufib](const P2& p) { return (bufib ? p.v : p.u); };
+
+    // the contour segments crossing into each strip
+    std::vector< std::vector<std::size_t> > stripsegs(wfibs.size());
+    std::size_t j = 0;
+    for (std::size_t i = 1; i < cpaths.pths.size(); i++)
+    {
+        while ((j < cpaths.brks.size()) && (cpaths.brks[j] < i))
+            j++;
+        if ((j < cpaths.brks.size()) && (cpaths.brks[j] == i))
+            continue; // no segment across a break
+
+        I1 srg = I1::SCombine(wpof(cpaths.pths[i - 1]), wpof(cpaths.pths[i]));
+        std::size_t is0 = std::max<std::size_t>(FindFibreIndex(wfibs, srg.lo, true), 1);
+        std::size_t is1 = std::min(FindFibreIndex(wfibs, srg.hi, false), wfibs.size() - 1);
+        for (std::size_t is = is0; is <= is1; is++)
+            stripsegs[is].push_back(i);
+    }
+
+    std::vector<std::size_t> cands;
+    for (std::size_t is = 1; is < wfibs.size(); is++)
+        if (!stripsegs[is].empty() && (wfibs[is].wp - wfibs[is - 1].wp >= 2 * resmin))
+            cands.push_back(is);
+
+    std::vector<S1> trialfibs(cands.size());
+    std::vector<FibreZsweep> trialzs(cands.size());
+    std::vector<char> bkeeps(cands.size(), 0);
+    ParallelFor(cands.size(), 4, [&](std::size_t i0, std::size_t i1)
+    {
+        std::vector<double> pws;
+        for (std::size_t ic = i0; ic < i1; ic++)
+        {
+            std::size_t is = cands[ic];
+            double wpmid = Half(wfibs[is - 1].wp, wfibs[is].wp);
+            trialfibs[ic].SetNew(wpmid, (bufib ? vrg : urg), (bufib ? S1::Fibre::u : S1::Fibre::v));
+            SliceNewFibre(trialfibs[ic], trialzs[ic]);
+
+            // where the contours cross the middle of the strip
+            pws.clear();
+            for (auto i : stripsegs[is])
+            {
+                const P2& a = cpaths.pths[i - 1];
+                const P2& b = cpaths.pths[i];
+                if ((wpof(a) < wpmid) != (wpof(b) < wpmid))
+                    pws.push_back(Along(InvAlong(wpmid, wpof(a), wpof(b)), wof(a), wof(b)));
+            }
+            std::sort(pws.begin(), pws.end());
+
+            const auto& ep = trialfibs[ic].ep;
+            bool bkeep = (pws.size() != ep.size());
+            for (std::size_t k = 0; !bkeep && (k < ep.size()); k++)
+                bkeep = (fabs(pws[k] - ep[k].w) > tol);
+            bkeeps[ic] = bkeep;
+        }
+    });
+
+    std::size_t nadded = 0;
+    for (std::size_t ic = 0; ic < cands.size(); ic++)
+    {
+        if (!bkeeps[ic])
+            continue;
+        std::size_t ix = InsertFibre(trialfibs[ic]);
+        if (!ufibzs.empty())
+        {
+            std::vector<FibreZsweep>& fibzs = (bufib ? ufibzs : vfibzs);
+            fibzs.insert(fibzs.begin() + ix, std::move(trialzs[ic]));
+        }
+        nadded++;
+    }
+    return nadded;
+}
+
+//////////////////////////////////////////////////////////////////////
+std::size_t Area2_gen::Refine(double tol, double resmin)
+{
+    if ((tol <= 0.0) || (psxb == nullptr))
+        return 0;
+
+    std::size_t nadded = 0;
+    while (true)
+    {
+        PathXSeries cpaths;
+        MakeContours(cpaths);
+        std::size_t nu = RefineStrips(true, cpaths, tol, resmin);
+        std::size_t nv = RefineStrips(false, cpaths, tol, resmin);
+        if (nu + nv == 0)
+            break;
+        nadded += nu + nv;
+    }
+    return nadded;
+}
+
 
-    for (auto& ufib : wve.ufibs)
+//////////////////////////////////////////////////////////////////////
+// the segments of the paths ending at points iseglo up to iseghi.  
+static void PathSegments(std::vector< std::pair<P2, P2> >& segs, const PathXSeries& pathxs, std::size_t iseglo, std::size_t iseghi)
+{
+    for (std::size_t i = std::max<std::size_t>(iseglo, 1); i < std::min(iseghi, pathxs.pths.size()); i++)
     {
-        ryg2.HoldFibre(&ufib);
-        HackToolpath(ryg2, pathxs, iseg, ptpath);
-        ryg2.ReleaseFibre();
+        if (!std::binary_search(pathxs.brks.begin(), pathxs.brks.end(), i))
+            segs.emplace_back(pathxs.pths[i - 1], pathxs.pths[i]);
     }
+}
 
-    for (auto& vfib : wve.vfibs)
+//////////////////////////////////////////////////////////////////////
+// each segment is hacked into only the fibres across its box inflated 
+// by the radius, whose indexes are looked up.  
+static void HackSegments(S2weave& wve, const std::vector< std::pair<P2, P2> >& segs, double rad)
+{
+    wve.Changed();
+    double radx = DiscReach(rad);
+
+    for (int iw = 0; iw < 2; iw++)
     {
-        ryg2.HoldFibre(&vfib);
-        HackToolpath(ryg2, pathxs, iseg, ptpath);
-        ryg2.ReleaseFibre();
+        bool bufib = (iw == 0);
+        std::vector<S1>& wfibs = (bufib ? wve.ufibs : wve.vfibs);
+
+        // the segments reaching each fibre, in path order, and the fibres with any.  
+        std::vector< std::vector<std::size_t> > fibsegs(wfibs.size());
+        std::vector<std::size_t> ixfibs;
+        for (std::size_t k = 0; k < segs.size(); k++)
+        {
+            double wa = (bufib ? segs[k].first.u : segs[k].first.v);
+            double wb = (bufib ? segs[k].second.u : segs[k].second.v);
+            std::size_t ilo = FindFibreIndex(wfibs, std::min(wa, wb) - radx, false);
+            std::size_t ihi = FindFibreIndex(wfibs, std::max(wa, wb) + radx, true);
+            for (std::size_t i = ilo; i < ihi; i++)
+            {
+                if (fibsegs[i].empty())
+                    ixfibs.push_back(i);
+                fibsegs[i].push_back(k);
+            }
+        }
+
+        ParallelFor(ixfibs.size(), 8, [&](std::size_t i0, std::size_t i1)
+        {
+            Ray_gen2 ryg2(rad);
+            for (std::size_t i = i0; i < i1; i++)
+            {
+                ryg2.HoldFibre(&wfibs[ixfibs[i]]);
+                for (std::size_t k : fibsegs[ixfibs[i]])
+                    ryg2.DiscSliceCapN(ryg2.Transform(segs[k].first), ryg2.Transform(segs[k].second));
+                ASSERT(ryg2.pfib->Check());
+                ryg2.ReleaseFibre();
+            }
+        });
     }
 }
 
+//////////////////////////////////////////////////////////////////////
+void HackToolpath(S2weave& wve, const PathXSeries& pathxs, std::size_t iseg, const P2& ptpath, double rad)
+{
+    std::vector< std::pair<P2, P2> > segs;
+    PathSegments(segs, pathxs, 1, iseg);
+    if ((iseg != 0) && (iseg < pathxs.pths.size()))
+        segs.emplace_back(pathxs.pths[iseg - 1], ptpath);
+    HackSegments(wve, segs, rad);
+}
+
+//////////////////////////////////////////////////////////////////////
+void HackToolpath(S2weave& wve, const PathXSeries& pathxs, std::size_t iseglo, std::size_t iseghi, double rad)
+{
+    std::vector< std::pair<P2, P2> > segs;
+    PathSegments(segs, pathxs, iseglo, iseghi);
+    HackSegments(wve, segs, rad);
+}
+
 
 //////////////////////////////////////////////////////////////////////
 void HackAreaOffset(S2weave& wve, const PathXSeries& paths, double rad)
 {
-    Ray_gen2 ryg2(rad);
+    wve.Changed();
 
-    for (auto& ufib : wve.ufibs)
+    for (int iw = 0; iw < 2; iw++)
     {
-        ryg2.HoldFibre(&ufib);
-        HackAreaOffset(ryg2, paths);
-        ryg2.ReleaseFibre();
+        std::vector<S1>& wfibs = (iw == 0 ? wve.ufibs : wve.vfibs);
+        PathXsweep pxs(paths, (iw == 0 ? S1::Fibre::u : S1::Fibre::v), rad);
+
+        // each chunk's front starts at its own first fibre.  
+        ParallelFor(wfibs.size(), std::max<std::size_t>(8, wfibs.size() / 16), [&](std::size_t i0, std::size_t i1)
+        {
+            Ray_gen2 ryg2(rad);
+            PathXsweep::Front front(pxs, wfibs[i0].wp);
+            for (std::size_t i = i0; i < i1; i++)
+            {
+                front.SweepTo(wfibs[i].wp);
+                ryg2.HoldFibre(&wfibs[i]);
+                HackAreaOffset(ryg2, paths, front.active);
+                ryg2.ReleaseFibre();
+            }
+        });
     }
+}
+
 
-    for (auto& vfib : wve.vfibs)
+//////////////////////////////////////////////////////////////////////
+// the same area as HackAreaOffset, to within dfres, with the offset 
+// read off a distance field rather than cut by a disc for every segment.  
+void HackAreaOffsetField(S2weave& wve, const PathXSeries& paths, double rad, double dfres)
+{
+    DistanceField df(wve.urg, wve.vrg, dfres);
+    df.Build(paths);
+    wve.Changed();
+
+    for (int iw = 0; iw < 2; iw++)
     {
-        ryg2.HoldFibre(&vfib);
-        HackAreaOffset(ryg2, paths);
-        ryg2.ReleaseFibre();
+        std::vector<S1>& wfibs = (iw == 0 ? wve.ufibs : wve.vfibs);
+        PathXsweep pxs(paths, (iw == 0 ? S1::Fibre::u : S1::Fibre::v), 0.0);
+        ParallelFor(wfibs.size(), std::max<std::size_t>(8, wfibs.size() / 16), [&](std::size_t i0, std::size_t i1)
+        {
+            Ray_gen2 ryg2(rad);
+            PathXsweep::Front front(pxs, wfibs[i0].wp);
+            for (std::size_t i = i0; i < i1; i++)
+            {
+                front.SweepTo(wfibs[i].wp);
+                ryg2.HoldFibre(&wfibs[i]);
+                HackAreaInside(ryg2, paths, front.active);
+                ryg2.ReleaseFibre();
+                df.MergeWithin(wfibs[i], rad);
+            }
+        });
     }
 }
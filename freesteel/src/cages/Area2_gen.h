@@ -26,11 +26,14 @@
 #include "bolts/P2.h"
 #include "cages/SurfX.h"
 #include "cages/SurfXboxed.h"
+#include "cages/FibreZsweep.h"
 
 
 //////////////////////////////////////////////////////////////////////
 void HackAreaOffset(S2weave& wve, const PathXSeries& paths, double rad);
+void HackAreaOffsetField(S2weave& wve, const PathXSeries& paths, double rad, double dfres); // through a DistanceField of spacing dfres
 void HackToolpath(S2weave& wve, const PathXSeries& paths, std::size_t ixseg, const P2& ptpath, double rad);
+void HackToolpath(S2weave& wve, const PathXSeries& paths, std::size_t iseglo, std::size_t iseghi, double rad); // the segments ending at points iseglo to iseghi - 1
 
 //////////////////////////////////////////////////////////////////////
 // this is a general model of a 2D area.  
@@ -41,14 +44,45 @@ public:
     double z;
     double r;
 
-    Area2_gen(const I1& urg, const I1& vrg, double res);
-    Area2_gen(const I1& urg, const I1& vrg, double res, SurfXboxed* lpsxb, double lr);
+    // per fibre candidate elements, empty until BuildZsweep is called.  
+    std::vector<FibreZsweep> ufibzs;
+    std::vector<FibreZsweep> vfibzs;
+    double zsweepband;
+
+    // the levels hacked down to so far, so new fibres can catch up.  
+    std::vector<double> zhist;
+
+    Area2_gen(const I1& urg, const I1& vrg, double res, Arena* lparena = nullptr);
+    Area2_gen(const I1& urg, const I1& vrg, double res, SurfXboxed* lpsxb, double lr, Arena* lparena = nullptr);
+
+    // for when the same weave is to be hacked down through many levels.  
+    // each fibre holds the elements for zband of depth at a time.  
+    void BuildZsweep(double lzsweepband);
+
+    // a copy of the weave at this level for the roughing to work on 
+    // while this one is hacked on down, without the slicing caches.  
+    Area2_gen Snapshot() const;
 
     // pull the path up to tolerance
     void HackDowntoZ(float lz);
+
+    // several ball weaves on the same grid and surface in one pass, 
+    // eg for a chain of tools from roughing down to rest roughing.  
+    static void HackDowntoZ(const std::vector<Area2_gen*>& a2gs, float lz);
     void FindInterior(SurfX& sx);
 
-    void MakeContours(PathXSeries& ftpaths);
+    // simptol above zero drops points closer than it to the simplified path
+    void MakeContours(PathXSeries& ftpaths, double simptol = 0.0);
+
+    // put in fibres halfway across strips the contours pass through 
+    // until the contours are within tol of them, or the strips are down to resmin.  
+    std::size_t Refine(double tol, double resmin);
+
+private:
+    explicit Area2_gen(const S2weave& wve);
+
+    void SliceNewFibre(S1& fib, FibreZsweep& fzs);
+    std::size_t RefineStrips(bool bufib, const PathXSeries& cpaths, double tol, double resmin);
 };
 
 #endif
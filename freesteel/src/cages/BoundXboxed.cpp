@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////////
+// FreeSteel -- Computer Aided Manufacture Algorithms
+// Copyright (C) 2004  Julian Todd and Martin Dunschen.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// See fslicense.txt and gpl.txt for further details
+////////////////////////////////////////////////////////////////////////////////
+#include "BoundXboxed.h"
+#include <algorithm>
+
+//////////////////////////////////////////////////////////////////////
+static I1 BoundRG(const std::vector<P2>& pths, bool bu, double boxwidth)
+{
+    if (pths.empty())
+        return I1(0.0, boxwidth);
+    I1 res;
+    for (std::size_t i = 0; i < pths.size(); i++)
+        res.Absorb((bu ? pths[i].u : pths[i].v), (i == 0));
+
+    // leave room either side so the partition isn't degenerate
+    return res.Inflate(boxwidth / 2);
+}
+
+//////////////////////////////////////////////////////////////////////
+BoundXboxed::BoundXboxed(const std::vector<P2>& lpths, double boxwidth)
+ : pths(lpths), upart(BoundRG(lpths, true, boxwidth), boxwidth), vpart(BoundRG(lpths, false, boxwidth), boxwidth),
+   boxsegs(upart.NumParts() * vpart.NumParts()), vstripsegs(vpart.NumParts())
+{
+    for (std::size_t i = 1; i < pths.size(); i++)
+    {
+        auto iurg = upart.FindPartRG(I1::SCombine(pths[i - 1].u, pths[i].u));
+        auto ivrg = vpart.FindPartRG(I1::SCombine(pths[i - 1].v, pths[i].v));
+        for (auto iu = iurg.first; iu <= iurg.second; iu++)
+            for (auto iv = ivrg.first; iv <= ivrg.second; iv++)
+                boxsegs[iu * vpart.NumParts() + iv].push_back(i);
+        for (auto iv = ivrg.first; iv <= ivrg.second; iv++)
+            vstripsegs[iv].push_back(i);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+void BoundXboxed::FindSegs(std::vector<std::size_t>& res, const P2& cpt, double crad) const
+{
+    res.clear();
+    I1 urg(cpt.u - crad, cpt.u + crad);
+    I1 vrg(cpt.v - crad, cpt.v + crad);
+    if (!urg.Intersect(upart.Getrg()) || !vrg.Intersect(vpart.Getrg()))
+        return;
+
+    auto iurg = upart.FindPartRG(urg);
+    auto ivrg = vpart.FindPartRG(vrg);
+    for (auto iu = iurg.first; iu <= iurg.second; iu++)
+        for (auto iv = ivrg.first; iv <= ivrg.second; iv++)
+        {
+            const std::vector<std::size_t>& segs = boxsegs[iu * vpart.NumParts() + iv];
+            res.insert(res.end(), segs.begin(), segs.end());
+        }
+
+    // a segment is in every box it overlaps
+    std::sort(res.begin(), res.end());
+    res.erase(std::unique(res.begin(), res.end()), res.end());
+}
+
+//////////////////////////////////////////////////////////////////////
+const std::vector<std::size_t>& BoundXboxed::HraySegs(double lv) const
+{
+    static const std::vector<std::size_t> none;
+    if (!vpart.Getrg().Contains(lv))
+        return none;
+    return vstripsegs[vpart.FindPart(lv)];
+}
+
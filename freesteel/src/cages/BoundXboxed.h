@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////////////
+// FreeSteel -- Computer Aided Manufacture Algorithms
+// Copyright (C) 2004  Julian Todd and Martin Dunschen.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// See fslicense.txt and gpl.txt for further details
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef BoundXboxed__h
+#define BoundXboxed__h
+#include <vector>
+#include "bolts/I1.h"
+#include "bolts/P2.h"
+#include "bolts/Partition1.h"
+
+//////////////////////////////////////////////////////////////////////
+// a closed boundary in a grid of boxes, so a circle only looks at the 
+// segments near it, and in strips across v for the crossings of 
+// horizontal rays.  segment i runs from pths[i - 1] to pths[i].  
+// it is not changed after it is made, so can be shared between threads.  
+class BoundXboxed
+{
+public: 
+    std::vector<P2> pths;
+
+    Partition1 upart;
+    Partition1 vpart;
+
+    // by iu * vpart.NumParts() + iv, the segments whose boxes overlap.  
+    std::vector< std::vector<std::size_t> > boxsegs;
+
+    // the segments whose v-range meets each strip.  
+    std::vector< std::vector<std::size_t> > vstripsegs;
+
+    BoundXboxed(const std::vector<P2>& lpths, double boxwidth);
+
+    // the segments which may come within crad of cpt, in order.  
+    void FindSegs(std::vector<std::size_t>& res, const P2& cpt, double crad) const;
+
+    // includes all the segments which the line v = lv crosses.  
+    const std::vector<std::size_t>& HraySegs(double lv) const;
+};
+
+#endif
+
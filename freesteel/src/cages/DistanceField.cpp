@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////
+// FreeSteel -- Computer Aided Manufacture Algorithms
+// Copyright (C) 2004  Julian Todd and Martin Dunschen.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// See fslicense.txt and gpl.txt for further details
+////////////////////////////////////////////////////////////////////////////////
+#include "cages/DistanceField.h"
+#include "bolts/debugfuncs.h"
+#include "bolts/smallfuncs.h"
+#include "bolts/threadfuncs.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+//////////////////////////////////////////////////////////////////////
+DistanceField::DistanceField(const I1& lurg, const I1& lvrg, double lh)
+ : urg(lurg), vrg(lvrg), h(lh), nu((std::size_t)std::ceil(urg.Leng() / h) + 1), nv((std::size_t)std::ceil(vrg.Leng() / h) + 1), dsq()
+{
+    ASSERT(h > 0.0);
+}
+
+//////////////////////////////////////////////////////////////////////
+void DistanceField::Seed(const P2& p)
+{
+    double x = std::round((p.u - urg.lo) / h);
+    double y = std::round((p.v - vrg.lo) / h);
+    std::size_t iu = (std::size_t)std::min(std::max(x, 0.0), (double)(nu - 1));
+    std::size_t iv = (std::size_t)std::min(std::max(y, 0.0), (double)(nv - 1));
+    dsq[iu * nv + iv] = 0.0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// d[q] = min over p of f[p] + (q - p)^2, by the lower envelope of the parabolas.  
+// v holds the apexes of the envelope and z where each takes over.  
+static void DistanceTransform1(const std::vector<double>& f, std::vector<double>& d, std::vector<std::size_t>& v, std::vector<double>& z)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    std::size_t n = f.size();
+    v.clear();
+    z.clear();
+    for (std::size_t q = 0; q < n; q++)
+    {
+        if (f[q] == inf)
+            continue;
+        double s = -inf;
+        while (!v.empty())
+        {
+            std::size_t p = v.back();
+            s = ((f[q] + Square((double)q)) - (f[p] + Square((double)p))) / (2.0 * (q - p));
+            if (s > z.back())
+                break;
+            v.pop_back();
+            z.pop_back();
+            s = -inf;
+        }
+        v.push_back(q);
+        z.push_back(s);
+    }
+
+    d.resize(n);
+    if (v.empty())
+    {
+        std::fill(d.begin(), d.end(), inf);
+        return;
+    }
+    std::size_t k = 0;
+    for (std::size_t q = 0; q < n; q++)
+    {
+        while ((k + 1 < v.size()) && (z[k + 1] < q))
+            k++;
+        d[q] = Square((double)q - (double)v[k]) + f[v[k]];
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+void DistanceField::Build(const PathXSeries& paths)
+{
+    dsq.assign(nu * nv, std::numeric_limits<double>::infinity());
+
+    // put the segments down at half the spacing, so no grid point is missed.  
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < paths.pths.size(); i++)
+    {
+        bool bbreak = ((j < paths.brks.size()) && (i == paths.brks[j]));
+        while ((j < paths.brks.size()) && (i == paths.brks[j]))
+            j++;
+        Seed(paths.pths[i]);
+        if ((i == 0) || bbreak)
+            continue;
+
+        const P2& a = paths.pths[i - 1];
+        const P2& b = paths.pths[i];
+        std::size_t n = (std::size_t)std::ceil((b - a).Len() * 2.0 / h);
+        for (std::size_t k = 1; k < n; k++)
+            Seed(Along((double)k / n, a, b));
+    }
+
+    // exact down the columns, then across the rows.  
+    ParallelFor(nu, 16, [this](std::size_t i0, std::size_t i1)
+    {
+        std::vector<double> f(nv);
+        std::vector<double> d;
+        std::vector<std::size_t> v;
+        std::vector<double> z;
+        for (std::size_t iu = i0; iu < i1; iu++)
+        {
+            std::copy(dsq.begin() + iu * nv, dsq.begin() + (iu + 1) * nv, f.begin());
+            DistanceTransform1(f, d, v, z);
+            std::copy(d.begin(), d.end(), dsq.begin() + iu * nv);
+        }
+    });
+
+    ParallelFor(nv, 16, [this](std::size_t i0, std::size_t i1)
+    {
+        std::vector<double> f(nu);
+        std::vector<double> d;
+        std::vector<std::size_t> v;
+        std::vector<double> z;
+        for (std::size_t iv = i0; iv < i1; iv++)
+        {
+            for (std::size_t iu = 0; iu < nu; iu++)
+                f[iu] = dsq[iu * nv + iv];
+            DistanceTransform1(f, d, v, z);
+            for (std::size_t iu = 0; iu < nu; iu++)
+                dsq[iu * nv + iv] = d[iu];
+        }
+    });
+}
+
+//////////////////////////////////////////////////////////////////////
+// distance at the k-th grid point along the line of a fibre, 
+// interpolated between the grid lines either side of it.  
+double DistanceField::ColumnDist(bool bufib, double wp, std::size_t k) const
+{
+    std::size_t nacross = (bufib ? nu : nv);
+    double x = (wp - (bufib ? urg.lo : vrg.lo)) / h;
+    std::size_t i0 = (std::size_t)std::min(std::max(std::floor(x), 0.0), (double)(nacross - 2));
+    double t = std::min(std::max(x - i0, 0.0), 1.0);
+
+    double d0 = std::sqrt(bufib ? dsq[i0 * nv + k] : dsq[k * nv + i0]);
+    double d1 = std::sqrt(bufib ? dsq[(i0 + 1) * nv + k] : dsq[k * nv + i0 + 1]);
+    return Along(t, d0, d1) * h;
+}
+
+//////////////////////////////////////////////////////////////////////
+double DistanceField::Dist(const P2& p) const
+{
+    double y = (p.v - vrg.lo) / h;
+    std::size_t k = (std::size_t)std::min(std::max(std::floor(y), 0.0), (double)(nv - 2));
+    double t = std::min(std::max(y - k, 0.0), 1.0);
+    return Along(t, ColumnDist(true, p.u, k), ColumnDist(true, p.u, k + 1));
+}
+
+//////////////////////////////////////////////////////////////////////
+// the ends of the ranges are where the sampled distance crosses rad.  
+void DistanceField::MergeWithin(S1& fib, double rad) const
+{
+    // nothing was seeded
+    if (dsq.empty() || std::isinf(dsq[0]))
+        return;
+
+    bool bufib = (fib.ftype == S1::Fibre::u);
+    std::size_t nalong = (bufib ? nv : nu);
+    double w0 = (bufib ? vrg.lo : urg.lo);
+
+    bool bin = false;
+    double wlo = 0.0;
+    double dprev = 0.0;
+    for (std::size_t k = 0; k < nalong; k++)
+    {
+        double d = ColumnDist(bufib, fib.wp, k);
+        double w = w0 + k * h;
+        if ((d <= rad) != bin)
+        {
+            double wc = (k == 0 ? w : w - h + h * (rad - dprev) / (d - dprev));
+            if (!bin)
+                wlo = wc;
+            else if (std::max(wlo, fib.wrg.lo) < std::min(wc, fib.wrg.hi))
+                fib.Merge(std::max(wlo, fib.wrg.lo), false, std::min(wc, fib.wrg.hi), false);
+            bin = !bin;
+        }
+        dprev = d;
+    }
+    if (bin && (std::max(wlo, fib.wrg.lo) < fib.wrg.hi))
+        fib.Merge(std::max(wlo, fib.wrg.lo), false, fib.wrg.hi, false);
+}
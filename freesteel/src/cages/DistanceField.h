@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////
+// FreeSteel -- Computer Aided Manufacture Algorithms
+// Copyright (C) 2004  Julian Todd and Martin Dunschen.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// See fslicense.txt and gpl.txt for further details
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DistanceField__h
+#define DistanceField__h
+#include <vector>
+#include "bolts/I1.h"
+#include "bolts/P2.h"
+#include "bolts/S1.h"
+#include "cages/PathXSeries.h"
+
+//////////////////////////////////////////////////////////////////////
+// the distance to a set of paths sampled on a square grid of spacing h.  
+// the paths are rasterised onto the grid points, whose Euclidean 
+// distance transform is then exact (done a column at a time, then a row 
+// at a time down the lower envelope of parabolas), so the distances 
+// are to within h of those to the true paths.  
+class DistanceField
+{
+public:
+    I1 urg;
+    I1 vrg;
+    double h;
+    std::size_t nu;
+    std::size_t nv;
+
+    // squared distances in grid units, indexed iu * nv + iv.  
+    std::vector<double> dsq;
+
+    DistanceField(const I1& lurg, const I1& lvrg, double lh);
+
+    void Build(const PathXSeries& paths);
+
+    // interpolated across the grid.  
+    double Dist(const P2& p) const;
+
+    // merge in the ranges of the fibre within rad of the paths.  
+    void MergeWithin(S1& fib, double rad) const;
+
+private:
+    void Seed(const P2& p);
+    double ColumnDist(bool bufib, double wp, std::size_t k) const;
+};
+
+#endif
@@ -0,0 +1,194 @@
+////////////////////////////////////////////////////////////////////////////////
+// FreeSteel -- Computer Aided Manufacture Algorithms
+// Copyright (C) 2004  Julian Todd and Martin Dunschen.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// See fslicense.txt and gpl.txt for further details
+////////////////////////////////////////////////////////////////////////////////
+#include "cages/FibreZsweep.h"
+#include <algorithm>
+#include <limits>
+#include "pits/NormRay_gen.h"
+
+//////////////////////////////////////////////////////////////////////
+// order by decreasing zhi, keeping one record per element.  
+// elements which cross several boxes come in more than once.  
+template<class T> void zsweepX<T>::Sort()
+{
+    std::sort(cks.begin(), cks.end(), [](const ckzX<T>& a, const ckzX<T>& b) { return a.pel < b.pel; });
+    cks.erase(std::unique(cks.begin(), cks.end(), [](const ckzX<T>& a, const ckzX<T>& b) { return a.pel == b.pel; }), cks.end());
+    std::stable_sort(cks.begin(), cks.end(), [](const ckzX<T>& a, const ckzX<T>& b) { return a.zhi > b.zhi; });
+
+    inext = 0;
+    active.clear();
+    zsweep = std::numeric_limits<double>::max();
+}
+
+//////////////////////////////////////////////////////////////////////
+template<class T> void zsweepX<T>::SweepDowntoZ(double lz)
+{
+    // going back up means starting the sweep again.  
+    if (lz > zsweep)
+    {
+        inext = 0;
+        active.clear();
+    }
+    zsweep = lz;
+
+    // retire the elements the ball has now gone below
+    active.erase(std::remove_if(active.begin(), active.end(), [&](std::size_t i) { return cks[i].zlo > lz; }), active.end());
+
+    // bring in the ones which have come into reach.  
+    // those passed over entirely between two levels are never made active.  
+    while ((inext < cks.size()) && (cks[inext].zhi >= lz))
+    {
+        if (cks[inext].zlo <= lz)
+            active.push_back(inext);
+        inext++;
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// the ball centre is at z + radball, so it can touch anything between z and z + 2 radball.  
+// the lateral ranges are those of the box search, but on the element rather than the box.  
+static bool InReach(const S1& fib, I1 wprg, I1 wrg, const P3& lo, const P3& hi)
+{
+    if (fib.ftype == S1::Fibre::u)
+        return wprg.Intersect(I1(lo.x, hi.x)) && wrg.Intersect(I1(lo.y, hi.y));
+    return wprg.Intersect(I1(lo.y, hi.y)) && wrg.Intersect(I1(lo.x, hi.x));
+}
+
+static P3 Lo(const P3& a, const P3& b)
+    { return P3(std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)); }
+static P3 Hi(const P3& a, const P3& b)
+    { return P3(std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)); }
+
+//////////////////////////////////////////////////////////////////////
+// only the elements whose z-range meets zband are kept.  
+void FibreZsweep::Build(const SurfXboxed& sxb, const S1& fib, double radball, const I1& zband)
+{
+    zspoints.cks.clear();
+    zsedges.cks.clear();
+    zstriangs.cks.clear();
+    zbandlo = zband.lo;
+    zbandhi = zband.hi;
+
+    double r = radball + sxb.searchbox_epsilon;
+    I1 wprg(fib.wp - r, fib.wp + r);
+    I1 wrg = fib.wrg.Inflate(r);
+    double zd = 2 * radball + sxb.searchbox_epsilon;
+
+    auto addpoint = [&](const P3* pp)
+    {
+        if (InReach(fib, wprg, wrg, *pp, *pp) && (pp->z - zd <= zband.hi) && (pp->z + sxb.searchbox_epsilon >= zband.lo))
+            zspoints.cks.emplace_back(pp->z - zd, pp->z + sxb.searchbox_epsilon, pp);
+    };
+    auto addedge = [&](const edgeX* ped)
+    {
+        P3 lo = Lo(*ped->p0, *ped->p1);
+        P3 hi = Hi(*ped->p0, *ped->p1);
+        if (InReach(fib, wprg, wrg, lo, hi) && (lo.z - zd <= zband.hi) && (hi.z + sxb.searchbox_epsilon >= zband.lo))
+            zsedges.cks.emplace_back(lo.z - zd, hi.z + sxb.searchbox_epsilon, ped);
+    };
+    auto addtriang = [&](const triangX* ptr)
+    {
+        P3 lo = Lo(Lo(*ptr->FirstPoint(), *ptr->SecondPoint()), *ptr->ThirdPoint());
+        P3 hi = Hi(Hi(*ptr->FirstPoint(), *ptr->SecondPoint()), *ptr->ThirdPoint());
+        if (InReach(fib, wprg, wrg, lo, hi) && (lo.z - zd <= zband.hi) && (hi.z + sxb.searchbox_epsilon >= zband.lo))
+            zstriangs.cks.emplace_back(lo.z - zd, hi.z + sxb.searchbox_epsilon, ptr);
+    };
+
+    // same drop down to the underlying surfx as in the slicing.  
+    if (sxb.buckets.empty())
+    {
+        for (auto& p : sxb.psurfx->vdX)     addpoint(&p);
+        for (auto& edge : sxb.psurfx->edX)  addedge(&edge);
+        for (auto& tri : sxb.psurfx->trX)   addtriang(&tri);
+    }
+
+    // the same boxes as SliceUFibre and SliceVFibre visit
+    else
+    {
+        bool bu = (fib.ftype == S1::Fibre::u);
+        I1 urg = (bu ? wprg : wrg);
+        if (urg.Intersect(sxb.gbxrg))
+        {
+            auto iurg = sxb.xpart.FindPartRG(urg);
+            for (auto iu = iurg.first; iu <= iurg.second; iu++)
+            {
+                I1 vrg = (bu ? wrg : wprg);
+                if (vrg.Intersect(sxb.gbyrg))
+                {
+                    std::pair<int, int> ivrg = sxb.yparts[iu].FindPartRG(vrg);
+                    for (int iv = ivrg.first; iv <= ivrg.second; iv++)
+                    {
+                        const bucketX& bk = sxb.buckets[iu][iv];
+                        for (auto& p : bk.ckpoints)
+                            addpoint(p);
+                        for (auto& edge : bk.ckedges)
+                            addedge(edge.edx);
+                        for (auto& tri : bk.cktriangs)
+                            addtriang(tri.trx);
+                    }
+                }
+            }
+        }
+    }
+
+    zspoints.Sort();
+    zsedges.Sort();
+    zstriangs.Sort();
+
+    // the sorted lists are kept until the band is left, so give back the slack.  
+    zspoints.cks.shrink_to_fit();
+    zsedges.cks.shrink_to_fit();
+    zstriangs.cks.shrink_to_fit();
+}
+
+
+//////////////////////////////////////////////////////////////////////
+template<S1::Fibre ft> static void SliceActiveF(const FibreZsweep& fzs, Ray_gen& rgen)
+{
+    for (auto i : fzs.zspoints.active)
+        rgen.BallSliceF<ft>(*fzs.zspoints.cks[i].pel);
+
+    for (auto i : fzs.zsedges.active)
+        rgen.BallSliceF<ft>(*(fzs.zsedges.cks[i].pel->p0), *(fzs.zsedges.cks[i].pel->p1));
+
+    for (auto i : fzs.zstriangs.active)
+    {
+        const triangX* tri = fzs.zstriangs.cks[i].pel;
+        rgen.BallSliceF<ft>(*tri->FirstPoint(), *tri->SecondPoint(), *tri->ThirdPoint());
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+// a level outside the band starts a new one from there down zbanddepth.  
+void FibreZsweep::SliceDowntoZ(Ray_gen& rgen, const SurfXboxed& sxb, double zbanddepth)
+{
+    if ((rgen.z < zbandlo) || (rgen.z > zbandhi))
+        Build(sxb, *rgen.pfib, rgen.radball, I1(rgen.z - zbanddepth, rgen.z));
+
+    zspoints.SweepDowntoZ(rgen.z);
+    zsedges.SweepDowntoZ(rgen.z);
+    zstriangs.SweepDowntoZ(rgen.z);
+
+    if (rgen.pfib->ftype == S1::Fibre::u)
+        SliceActiveF<S1::Fibre::u>(*this, rgen);
+    else
+        SliceActiveF<S1::Fibre::v>(*this, rgen);
+}
@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////
+// FreeSteel -- Computer Aided Manufacture Algorithms
+// Copyright (C) 2004  Julian Todd and Martin Dunschen.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// See fslicense.txt and gpl.txt for further details
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef FibreZsweep__h
+#define FibreZsweep__h
+#include <vector>
+#include "bolts/S1.h"
+#include "cages/SurfXboxed.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// an element of the surface near a fibre, with the range of tool tip 
+// heights over which the ball can touch it.  
+template<class T> struct ckzX
+{
+    double zlo;
+    double zhi;
+    const T* pel;
+
+    ckzX(double lzlo, double lzhi, const T* lpel) :
+        zlo(lzlo), zhi(lzhi), pel(lpel) {;}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// the events are in decreasing zhi, so lowering the tool brings them 
+// into play in sequence.  active holds the indexes of those whose range 
+// contains the current z, in increasing order.  
+template<class T> struct zsweepX
+{
+    std::vector< ckzX<T> > cks;
+    std::size_t inext;
+    std::vector<std::size_t> active;
+    double zsweep;
+
+    zsweepX() : cks(), inext(0), active(), zsweep() {;}
+
+    void Sort();
+    void SweepDowntoZ(double lz);
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// the surface elements which the ball running along one fibre can touch 
+// in a band of heights, found from the boxes once per band so that each 
+// new level only visits the elements whose z-range it is in.  
+// the band bounds the memory held, at one box search per band.  
+class FibreZsweep
+{
+public:
+    zsweepX<P3> zspoints;
+    zsweepX<edgeX> zsedges;
+    zsweepX<triangX> zstriangs;
+    double zbandlo; // the heights the lists are good for, empty when lo > hi
+    double zbandhi;
+
+    FibreZsweep() : zbandlo(1.0), zbandhi(0.0) {;}
+
+    void Build(const SurfXboxed& sxb, const S1& fib, double radball, const I1& zband);
+    void SliceDowntoZ(class Ray_gen& rgen, const SurfXboxed& sxb, double zbanddepth);
+};
+
+#endif
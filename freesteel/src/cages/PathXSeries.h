@@ -22,9 +22,62 @@
 #ifndef PathXSeries__h
 #define PathXSeries__h
 #include <vector>
+#include <cmath>
 #include "bolts/P2.h"
 #include "bolts/P3.h"
 
+//////////////////////////////////////////////////////////////////////
+// how a path gets to a point from the one before: along a straight line, 
+// or round an arc about cen in the plane, rising evenly if z changes.  
+struct ArcX
+{
+    P2 cen;
+    int dir; // 0 for a straight line, 1 anticlockwise, -1 clockwise
+
+    ArcX() : cen(), dir(0) {}
+    ArcX(const P2& lcen, int ldir) : cen(lcen), dir(ldir) {}
+
+    // the angle turned going from a to b in the direction of the arc, in [0, 2pi).  
+    double Sweep(const P2& a, const P2& b) const
+    {
+        double res = dir * (std::atan2(b.v - cen.v, b.u - cen.u) - std::atan2(a.v - cen.v, a.u - cen.u));
+        if (res < 0.0)
+            res += M2PI;
+        return res;
+    }
+
+    double Len(const P2& a, const P2& b) const
+    {
+        return (dir == 0 ? (b - a).Len() : (a - cen).Len() * Sweep(a, b));
+    }
+
+    P2 Along(double lam, const P2& a, const P2& b) const
+    {
+        if (dir == 0)
+            return P2(a.u + (b.u - a.u) * lam, a.v + (b.v - a.v) * lam);
+        double th = dir * lam * Sweep(a, b);
+        P2 ra = a - cen;
+        return cen + P2(ra.u * std::cos(th) - ra.v * std::sin(th), ra.u * std::sin(th) + ra.v * std::cos(th));
+    }
+};
+
+// the length of the move into link point i, and a point along it.  
+inline double LinkSegLen(const std::vector<P3>& link, const std::vector<ArcX>& arcs, std::size_t i)
+{
+    const P3& a = link[i - 1];
+    const P3& b = link[i];
+    double lenxy = (arcs.empty() ? ArcX() : arcs[i]).Len(P2(a.x, a.y), P2(b.x, b.y));
+    return std::sqrt(lenxy * lenxy + (b.z - a.z) * (b.z - a.z));
+}
+
+inline P3 LinkAlong(double lam, const std::vector<P3>& link, const std::vector<ArcX>& arcs, std::size_t i)
+{
+    const P3& a = link[i - 1];
+    const P3& b = link[i];
+    P2 p = (arcs.empty() ? ArcX() : arcs[i]).Along(lam, P2(a.x, a.y), P2(b.x, b.y));
+    return P3(p.u, p.v, a.z + (b.z - a.z) * lam);
+}
+
 //////////////////////////////////////////////////////////////////////
 // a series of toolpaths
 class PathXSeries		
@@ -39,6 +92,10 @@ public:
     // runs parallel to the brks array.
     std::vector< std::vector<P3> > linkpths;
 
+    // runs parallel to linkpths, each either empty for straight lines 
+    // or with the arc into each point (the first unused).  
+    std::vector< std::vector<ArcX> > linkarcs;
+
     PathXSeries() : z(0) {}
     PathXSeries(double lz) : z(lz) {}
 
@@ -57,6 +114,7 @@ public:
     {
         brks.push_back(pths.size());
         linkpths.emplace_back();
+        linkarcs.emplace_back();
     }
 
     void Pop_back()
@@ -96,6 +154,11 @@ public:
         return linkpths[j][i].z;
     }
 
+    ArcX GetLinkArc(std::size_t j, std::size_t i) const
+    {
+        return (linkarcs[j].empty() ? ArcX() : linkarcs[j][i]);
+    }
+
     std::size_t GetNpts() const
     {
         return pths.size();
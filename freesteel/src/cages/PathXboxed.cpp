@@ -22,9 +22,11 @@
 #include "bolts/smallfuncs.h"
 
 //////////////////////////////////////////////////////////////////////
-PathXboxed::PathXboxed(PathXSeries* lppathx, const I1& lgburg, double boxwidth)
- : ppathx(lppathx), gburg(lgburg), bGeoOutLeft(false), bGeoOutRight(false),
-   upart(gburg, boxwidth), puckets(upart.NumParts()),
+PathXboxed::PathXboxed(PathXSeries* lppathx, const I1& lgburg, const I1& lgbvrg, double boxwidth)
+ : ppathx(lppathx), gburg(lgburg), gbvrg(lgbvrg), 
+   bGeoOutLeft(false), bGeoOutRight(false), bGeoOutDown(false), bGeoOutUp(false),
+   upart(gburg, boxwidth), vpart(gbvrg, boxwidth), 
+   puckets(upart.NumParts(), std::vector<pucketX>(vpart.NumParts())),
    idups(), maxidup(0)
 
 {
@@ -61,17 +63,22 @@ void PathXboxed::PutSegment(std::size_t iseg, bool bFirst, bool bRemove)
 {
     // do the point addition
     // if we get the next part of the arc, we can narrow it down a lot.
+    // a point off a corner is out in both u and v.  
     P2& pp = ppathx->pths[iseg];
+    bool bOut = false;
     if (pp.u < gburg.lo)
-        bGeoOutLeft = true;
-    if (pp.u > gburg.hi)
-        bGeoOutRight = true;
-    else
+        bGeoOutLeft = bOut = true;
+    else if (pp.u > gburg.hi)
+        bGeoOutRight = bOut = true;
+    if (pp.v < gbvrg.lo)
+        bGeoOutDown = bOut = true;
+    else if (pp.v > gbvrg.hi)
+        bGeoOutUp = bOut = true;
+    if (!bOut)
     {
-        ASSERT(gburg.Contains(pp.u));
         auto iu = upart.FindPart(pp.u);
-        ASSERT(iu < puckets.size());
-        puckets[iu].ckpoints.push_back(iseg);
+        auto iv = vpart.FindPart(pp.v);
+        puckets[iu][iv].ckpoints.push_back(iseg);
     }
 
     // quit if no line to be added with this.
@@ -88,18 +95,36 @@ void PathXboxed::PutSegment(std::size_t iseg, bool bFirst, bool bRemove)
     if (!urg.Intersect(gburg))
         return;
 
+    // the v-range of the segment across each of its u-strips.
     auto iurg = upart.FindPartRG(urg);
+    std::vector< std::pair<std::size_t, std::size_t> > ivrgs;
+    std::vector<I1> vrgs;
+    double v1 = PTcrossU(upart.GetPart(iurg.first).lo, p0, p1);
+    for (auto iu = iurg.first; iu <= iurg.second; iu++)
+    {
+        double v0 = v1;
+        v1 = PTcrossU(upart.GetPart(iu).hi, p0, p1);
+        vrgs.push_back(I1::SCombine(v0, v1));
+        I1 vrg = vrgs.back();
+        if (vrg.Intersect(gbvrg))
+            ivrgs.push_back(vpart.FindPartRG(vrg));
+        else
+            ivrgs.emplace_back(1, 0); // none
+    }
 
-    // take away this index from each of the strips
+    // take away this index from each of the boxes
     if (bRemove)
     {
         for (auto iu = iurg.first; iu <= iurg.second; iu++)
         {
-            if (puckets[iu].cklines.back().iseg == iseg)
-                puckets[iu].cklines.pop_back();
-            else
+            for (auto iv = ivrgs[iu - iurg.first].first; iv <= ivrgs[iu - iurg.first].second; iv++)
             {
-                ASSERT(0); // get it out somewhere in the middle / must have been sorted into it.
+                if (puckets[iu][iv].cklines.back().iseg == iseg)
+                    puckets[iu][iv].cklines.pop_back();
+                else
+                {
+                    ASSERT(0); // get it out somewhere in the middle / must have been sorted into it.
+                }
             }
         }
 
@@ -109,20 +134,69 @@ void PathXboxed::PutSegment(std::size_t iseg, bool bFirst, bool bRemove)
 
 
     // decide if we will find duplicates.
-    int idup = -1;
-    if(iurg.first != iurg.second)
+    std::size_t nboxes = 0;
+    for (const auto& ivrg : ivrgs)
+        if (ivrg.first <= ivrg.second)
+            nboxes += ivrg.second - ivrg.first + 1;
+    std::ptrdiff_t idup = -1;
+    if (nboxes > 1)
     {
         idup = idups.size();
         idups.push_back(0);
     }
 
-    // loop across the strips now.
-    double v1 = PTcrossU(upart.GetPart(iurg.first).lo, p0, p1);
+    // loop across the boxes now.
     for (auto iu = iurg.first; iu <= iurg.second; iu++)
     {
-        double v0 = v1;
-        v1 = PTcrossU(upart.GetPart(iu).hi, p0, p1);
-        puckets[iu].cklines.emplace_back(iseg, idup, Half(v0, v1), fabs(v1 - v0) / 2);
+        const I1& vrg = vrgs[iu - iurg.first];
+        for (auto iv = ivrgs[iu - iurg.first].first; iv <= ivrgs[iu - iurg.first].second; iv++)
+            puckets[iu][iv].cklines.emplace_back(iseg, idup, vrg.Half(), vrg.Leng() / 2);
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////
+bool PathXboxed::BoxesCover(const I1& urg, const I1& vrg) const
+{
+    return !((bGeoOutLeft && (urg.lo < gburg.lo)) || (bGeoOutRight && (urg.hi > gburg.hi)) || 
+             (bGeoOutDown && (vrg.lo < gbvrg.lo)) || (bGeoOutUp && (vrg.hi > gbvrg.hi)));
+}
+
+//////////////////////////////////////////////////////////////////////
+void PathXboxed::FindLines(std::vector<std::size_t>& res, const I1& urg, const I1& vrg) const
+{
+    res.clear();
+    I1 lurg = urg;
+    I1 lvrg = vrg;
+    if (!lurg.Intersect(gburg) || !lvrg.Intersect(gbvrg))
+        return;
+
+    // increment duplicates finder.
+    maxidup++;
+
+    auto iurg = upart.FindPartRG(lurg);
+    auto ivrg = vpart.FindPartRG(lvrg);
+    for (auto iu = iurg.first; iu <= iurg.second; iu++)
+    {
+        for (auto iv = ivrg.first; iv <= ivrg.second; iv++)
+        {
+            for (const auto& ckl : puckets[iu][iv].cklines)
+            {
+                // the line may not reach far enough across the strip
+                if (fabs(ckl.vmid - vrg.Half()) > ckl.vrad + vrg.Leng() / 2)
+                    continue;
+
+                // mark for duplicates
+                if (ckl.idup != -1)
+                {
+                    if (idups[ckl.idup] == maxidup)
+                        continue;
+                    ASSERT(idups[ckl.idup] < maxidup);
+                    idups[ckl.idup] = maxidup;
+                }
+                res.push_back(ckl.iseg);
+            }
+        }
     }
 }
 
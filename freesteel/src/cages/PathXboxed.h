@@ -31,8 +31,8 @@
 struct ckpline 
 {
     std::size_t iseg;
-    mutable std::ptrdiff_t idup;
-    double vmid; // the vrange is (vmid - vrad, vmid + vrad)
+    std::ptrdiff_t idup; // -1 if in only one box, otherwise points into the duplicates vector.
+    double vmid; // the vrange across the u-strip is (vmid - vrad, vmid + vrad)
     double vrad;
 
     ckpline(std::size_t liseg, std::ptrdiff_t lidup, double lvmid, double lvrad)
@@ -54,19 +54,29 @@ public:
     PathXSeries* ppathx;
 
     I1 gburg;
+    I1 gbvrg;
     bool bGeoOutLeft;
     bool bGeoOutRight;
+    bool bGeoOutDown;
+    bool bGeoOutUp;
 
     Partition1 upart;
+    Partition1 vpart;
 
-    // simple buckets running parallel to the partitions.
-    std::vector<pucketX> puckets;
+    // simple buckets running parallel to the partitions, by [iu][iv].
+    std::vector< std::vector<pucketX> > puckets;
 
     // integer places where the duplicate counters are looked up.
-    std::vector<int> idups;
+    mutable std::vector<int> idups;
     mutable int maxidup;
 
-    PathXboxed(PathXSeries* lppathx, const I1& lgburg, double boxwidth);
+    PathXboxed(PathXSeries* lppathx, const I1& lgburg, const I1& lgbvrg, double boxwidth);
+
+    // false if some of the path in this range is outside the boxes.
+    bool BoxesCover(const I1& urg, const I1& vrg) const;
+
+    // the lines which may cross this range, each once.
+    void FindLines(std::vector<std::size_t>& res, const I1& urg, const I1& vrg) const;
 
     void PutSegment(std::size_t iseg, bool bFirst, bool bRemove);
     void Add(const P2& p1);
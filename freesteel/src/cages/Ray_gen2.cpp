@@ -57,21 +57,29 @@ void Ray_gen2::ReleaseFibre()
 
 
 //////////////////////////////////////////////////////////////////////
-void Ray_gen2::LineCut(const P2& a, const P2& b)  
+template<S1::Fibre ft> void Ray_gen2::LineCutF(const P2& a, const P2& b)  
 {
 	// requires cclockwise paths
 	if ((a.u < 0.0) != (b.u < 0.0)) 
 	{
 		double al = a.u / (a.u - b.u); 
 		double lw = Along(al, a.v, b.v); 
-        bool lblower = ((a.u < 0.0) != (pfib->ftype == S1::Fibre::u)); // account for reflection
+        bool lblower = ((a.u < 0.0) != (ft == S1::Fibre::u)); // account for reflection
         scuts.emplace_back(lw, !lblower);
 	}
 }
 
+void Ray_gen2::LineCut(const P2& a, const P2& b)  
+{
+    if (pfib->ftype == S1::Fibre::u)
+        LineCutF<S1::Fibre::u>(a, b);
+    else
+        LineCutF<S1::Fibre::v>(a, b);
+}
+
 P2 Ray_gen2::Transform(const P2& p)
 {
-    return (pfib->ftype == S1::Fibre::u ? P2(p.u - pfib->wp, p.v) : P2(p.v - pfib->wp, p.u));
+    return (pfib->ftype == S1::Fibre::u ? TransformF<S1::Fibre::u>(p) : TransformF<S1::Fibre::v>(p));
 }
 
 
@@ -174,7 +182,7 @@ void Ray_gen2::DiscSliceCapN(const P2& a, const P2& b)
 }
 
 //////////////////////////////////////////////////////////////////////
-void HackToolpath(Ray_gen2& rgen2, const PathXSeries& pathxs, std::size_t iseg, const P2& ptpath)
+template<S1::Fibre ft> static void HackToolpathF(Ray_gen2& rgen2, const PathXSeries& pathxs, std::size_t iseg, const P2& ptpath)
 {
     std::size_t j = 0;
     P2 tb;
@@ -182,7 +190,7 @@ void HackToolpath(Ray_gen2& rgen2, const PathXSeries& pathxs, std::size_t iseg,
     for (std::size_t i = 0; i < iseg; ++i)
     {
         P2 ta = tb;
-        tb = rgen2.Transform(pathxs.pths[i]);
+        tb = rgen2.TransformF<ft>(pathxs.pths[i]);
 
         if ((j == pathxs.brks.size()) || (i < pathxs.brks[j]))
         {
@@ -200,7 +208,8 @@ void HackToolpath(Ray_gen2& rgen2, const PathXSeries& pathxs, std::size_t iseg,
                 j++;
             while ((j < pathxs.brks.size()) && (i == pathxs.brks[j]));
 
-            bFirstPoint = true;
+            // this is the first point of the next path, so the segment to the following point counts.
+            bFirstPoint = false;
         }
     }
 
@@ -208,17 +217,27 @@ void HackToolpath(Ray_gen2& rgen2, const PathXSeries& pathxs, std::size_t iseg,
     {
         ASSERT(!bFirstPoint);
         P2 ta = tb;
-        tb = rgen2.Transform(ptpath);
+        tb = rgen2.TransformF<ft>(ptpath);
         rgen2.DiscSliceCapN(ta, tb);
     }
 
     ASSERT(rgen2.pfib->Check());
 }
 
+//////////////////////////////////////////////////////////////////////
+void HackToolpath(Ray_gen2& rgen2, const PathXSeries& pathxs, std::size_t iseg, const P2& ptpath)
+{
+    if (rgen2.pfib->ftype == S1::Fibre::u)
+        HackToolpathF<S1::Fibre::u>(rgen2, pathxs, iseg, ptpath);
+    else
+        HackToolpathF<S1::Fibre::v>(rgen2, pathxs, iseg, ptpath);
+}
+
 
 
 //////////////////////////////////////////////////////////////////////
-void HackAreaOffset(Ray_gen2& rgen2, const PathXSeries paths)
+// bdisc false leaves out the discs, so only the inside of the paths is put in.  
+template<S1::Fibre ft> static void HackAreaOffsetF(Ray_gen2& rgen2, const PathXSeries& paths, bool bdisc)
 {
     std::size_t j = 0;
     P2 tb;
@@ -226,14 +245,15 @@ void HackAreaOffset(Ray_gen2& rgen2, const PathXSeries paths)
     for (std::size_t i = 0; i < paths.pths.size(); i++)
     {
         P2 ta = tb;
-        tb = rgen2.Transform(paths.pths[i]);
+        tb = rgen2.TransformF<ft>(paths.pths[i]);
 
         if ((j == paths.brks.size()) || (i < paths.brks[j]))
         {
             if (!bFirstPoint)
             {
-                rgen2.LineCut(ta, tb);
-                rgen2.DiscSliceCapN(ta, tb);
+                rgen2.LineCutF<ft>(ta, tb);
+                if (bdisc)
+                    rgen2.DiscSliceCapN(ta, tb);
             }
             else
                 bFirstPoint = false;
@@ -247,9 +267,112 @@ void HackAreaOffset(Ray_gen2& rgen2, const PathXSeries paths)
                 j++;
             while ((j < paths.brks.size()) && (i == paths.brks[j]));
 
-            bFirstPoint = true;
+            // this is the first point of the next path, so the segment to the following point counts.
+            bFirstPoint = false;
         }
     }
     ASSERT(rgen2.pfib->Check());
 }
 
+//////////////////////////////////////////////////////////////////////
+void HackAreaOffset(Ray_gen2& rgen2, const PathXSeries& paths)
+{
+    if (rgen2.pfib->ftype == S1::Fibre::u)
+        HackAreaOffsetF<S1::Fibre::u>(rgen2, paths, true);
+    else
+        HackAreaOffsetF<S1::Fibre::v>(rgen2, paths, true);
+}
+
+//////////////////////////////////////////////////////////////////////
+void HackAreaInside(Ray_gen2& rgen2, const PathXSeries& paths)
+{
+    if (rgen2.pfib->ftype == S1::Fibre::u)
+        HackAreaOffsetF<S1::Fibre::u>(rgen2, paths, false);
+    else
+        HackAreaOffsetF<S1::Fibre::v>(rgen2, paths, false);
+}
+
+
+//////////////////////////////////////////////////////////////////////
+PathXsweep::PathXsweep(const PathXSeries& paths, S1::Fibre ftype, double rad)
+    : segslo(), segshi(), segrgs(paths.pths.size())
+{
+    double radx = DiscReach(rad);
+    bool bufib = (ftype == S1::Fibre::u);
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < paths.pths.size(); i++)
+    {
+        bool bbreak = ((j < paths.brks.size()) && (i == paths.brks[j]));
+        while ((j < paths.brks.size()) && (i == paths.brks[j]))
+            j++;
+        if ((i == 0) || bbreak)
+            continue;
+
+        double wa = (bufib ? paths.pths[i - 1].u : paths.pths[i - 1].v);
+        double wb = (bufib ? paths.pths[i].u : paths.pths[i].v);
+        segrgs[i] = I1(std::min(wa, wb) - radx, std::max(wa, wb) + radx);
+        segslo.emplace_back(segrgs[i].lo, i);
+        segshi.emplace_back(segrgs[i].hi, i);
+    }
+    std::sort(segslo.begin(), segslo.end());
+    std::sort(segshi.begin(), segshi.end());
+}
+
+//////////////////////////////////////////////////////////////////////
+// the state SweepTo(wp) would have left, without going through the segments before.  
+PathXsweep::Front::Front(const PathXsweep& lpxs, double wp)
+    : pxs(&lpxs), ilo(0), ihi(0), active()
+{
+    ilo = std::upper_bound(pxs->segslo.begin(), pxs->segslo.end(), wp, [](double w, const std::pair<double, std::size_t>& s) { return w < s.first; }) - pxs->segslo.begin();
+    ihi = std::lower_bound(pxs->segshi.begin(), pxs->segshi.end(), wp, [](const std::pair<double, std::size_t>& s, double w) { return s.first < w; }) - pxs->segshi.begin();
+
+    std::vector<std::size_t> isegs;
+    for (std::size_t k = 0; k < ilo; k++)
+        if (pxs->segrgs[pxs->segslo[k].second].hi >= wp)
+            isegs.push_back(pxs->segslo[k].second);
+    std::sort(isegs.begin(), isegs.end());
+    active.insert(isegs.begin(), isegs.end());
+}
+
+//////////////////////////////////////////////////////////////////////
+// all the segments which have come in by wp go in before those which 
+// have passed out go, so one jumped over entirely is put in and taken out.  
+void PathXsweep::Front::SweepTo(double wp)
+{
+    while ((ilo < pxs->segslo.size()) && (pxs->segslo[ilo].first <= wp))
+        active.insert(pxs->segslo[ilo++].second);
+    while ((ihi < pxs->segshi.size()) && (pxs->segshi[ihi].first < wp))
+        active.erase(pxs->segshi[ihi++].second);
+}
+
+//////////////////////////////////////////////////////////////////////
+template<S1::Fibre ft> static void HackAreaOffsetSegsF(Ray_gen2& rgen2, const PathXSeries& paths, const std::set<std::size_t>& isegs, bool bdisc)
+{
+    for (std::size_t i : isegs)
+    {
+        P2 ta = rgen2.TransformF<ft>(paths.pths[i - 1]);
+        P2 tb = rgen2.TransformF<ft>(paths.pths[i]);
+        rgen2.LineCutF<ft>(ta, tb);
+        if (bdisc)
+            rgen2.DiscSliceCapN(ta, tb);
+    }
+    ASSERT(rgen2.pfib->Check());
+}
+
+//////////////////////////////////////////////////////////////////////
+void HackAreaOffset(Ray_gen2& rgen2, const PathXSeries& paths, const std::set<std::size_t>& isegs)
+{
+    if (rgen2.pfib->ftype == S1::Fibre::u)
+        HackAreaOffsetSegsF<S1::Fibre::u>(rgen2, paths, isegs, true);
+    else
+        HackAreaOffsetSegsF<S1::Fibre::v>(rgen2, paths, isegs, true);
+}
+
+//////////////////////////////////////////////////////////////////////
+void HackAreaInside(Ray_gen2& rgen2, const PathXSeries& paths, const std::set<std::size_t>& isegs)
+{
+    if (rgen2.pfib->ftype == S1::Fibre::u)
+        HackAreaOffsetSegsF<S1::Fibre::u>(rgen2, paths, isegs, false);
+    else
+        HackAreaOffsetSegsF<S1::Fibre::v>(rgen2, paths, isegs, false);
+}
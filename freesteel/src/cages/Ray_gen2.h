@@ -26,6 +26,7 @@
 #include "bolts/P2.h"
 #include "cages/PathXSeries.h"
 #include <vector>
+#include <set>
 
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
@@ -53,10 +54,54 @@ public:
     void LineCut(const P2& a, const P2& b); // fills in the scuts
 
     P2 Transform(const P2& p);
+
+    // versions for when the fibre orientation is fixed outside the loop
+    template<S1::Fibre ft> void LineCutF(const P2& a, const P2& b);
+    template<S1::Fibre ft> P2 TransformF(const P2& p) const
+        { return (ft == S1::Fibre::u ? P2(p.u - pfib->wp, p.v) : P2(p.v - pfib->wp, p.u)); }
+};
+
+//////////////////////////////////////////////////////////////////////
+// a hair over rad, so that a segment DiscSliceCapN would only just 
+// catch is not lost to rounding when finding the fibres it reaches.  
+inline double DiscReach(double rad) { return rad * (1.0 + 1e-9) + 1e-9; }
+
+//////////////////////////////////////////////////////////////////////
+// the segments of the paths spread out across one direction of fibre, 
+// each over the range of wp it comes within rad of.  
+// segments are known by the index of their second point.  
+class PathXsweep
+{
+public:
+    std::vector< std::pair<double, std::size_t> > segslo; // sorted by the low end of the range
+    std::vector< std::pair<double, std::size_t> > segshi; // sorted by the high end
+    std::vector<I1> segrgs; // the range of each segment, by its index in the path
+
+    PathXsweep(const PathXSeries& paths, S1::Fibre ftype, double rad);
+
+    // a sweep through the fibres in increasing wp, holding the segments 
+    // whose range contains it in path order.  each segment goes in and out once.  
+    // one starting part way along takes up only the segments already in at wp.  
+    struct Front
+    {
+        const PathXsweep* pxs;
+        std::size_t ilo;
+        std::size_t ihi;
+        std::set<std::size_t> active;
+
+        Front(const PathXsweep& lpxs) : pxs(&lpxs), ilo(0), ihi(0), active() {;}
+        Front(const PathXsweep& lpxs, double wp);
+        void SweepTo(double wp);
+    };
 };
 
 void HackToolpath(Ray_gen2& rgen2, const PathXSeries& pathxs, std::size_t iseg, const P2& ptpath);
-void HackAreaOffset(Ray_gen2& rgen2, const PathXSeries paths);
+void HackAreaOffset(Ray_gen2& rgen2, const PathXSeries& paths);
+void HackAreaInside(Ray_gen2& rgen2, const PathXSeries& paths); // the scuts only, for when the offset is done elsewhere
+
+// the same only looking at the segments of a sweep's front
+void HackAreaOffset(Ray_gen2& rgen2, const PathXSeries& paths, const std::set<std::size_t>& isegs);
+void HackAreaInside(Ray_gen2& rgen2, const PathXSeries& paths, const std::set<std::size_t>& isegs);
 
 #endif
 
@@ -21,6 +21,7 @@
 #include "S2weave.h"
 #include "bolts/I1.h"
 #include "bolts/maybe.h"
+#include <algorithm>
 
 
 //////////////////////////////////////////////////////////////////////
@@ -30,33 +31,55 @@ P2 S2weaveB1iter::GetPoint() const
 }
 
 
+//////////////////////////////////////////////////////////////////////
+std::size_t FindFibreIndex(const std::vector<S1>& wfibs, double lwp, bool bstrict)
+{
+    auto bbefore = [&](std::size_t i) { return (bstrict ? (wfibs[i].wp <= lwp) : (wfibs[i].wp < lwp)); };
+    auto bfound = [&](std::size_t i) { return ((i == 0) || bbefore(i - 1)) && ((i == wfibs.size()) || !bbefore(i)); };
+
+    std::size_t n = wfibs.size();
+    if ((n < 2) || (wfibs.back().wp <= wfibs.front().wp))
+        return (((n != 0) && bbefore(0)) ? n : 0);
+
+    // the fibres are regularly spaced unless the weave has been subdivided.  
+    double lam = (lwp - wfibs.front().wp) / (wfibs.back().wp - wfibs.front().wp);
+    std::size_t ig = (lam <= 0.0 ? 0 : (lam >= 1.0 ? n : (std::size_t)(lam * (n - 1)) + 1));
+    if (bfound(ig))
+        return ig;
+    if ((ig > 0) && bfound(ig - 1))
+        return ig - 1;
+    if ((ig < n) && bfound(ig + 1))
+        return ig + 1;
+
+    return std::partition_point(wfibs.begin(), wfibs.end(), [&](const S1& fib) { return (bstrict ? (fib.wp <= lwp) : (fib.wp < lwp)); }) - wfibs.begin();
+}
+
+
 //////////////////////////////////////////////////////////////////////
 //optional int
 static maybe<std::size_t> FindInwards(const std::vector<S1>& wfibs, double lw, bool blower, double lwp, double lwpend, bool bedge)
 {
     if (wfibs.empty()) return {};
 
-	// just do this as an inefficient loop for now.  
+	// start at the first fibre beyond lwp and step out towards lwpend
 	if (blower)
 	{
-        for (std::size_t i = 0; i < wfibs.size(); i++)
+        for (std::size_t i = FindFibreIndex(wfibs, lwp, !bedge); i < wfibs.size(); i++)
 		{
 			if (wfibs[i].wp > lwpend) 
 				break; 
-			if (bedge ? (wfibs[i].wp >= lwp) : (wfibs[i].wp > lwp)) 
-				if (wfibs[i].Contains(lw)) 
-                    return {i};
+			if (wfibs[i].Contains(lw)) 
+                return {i};
 		}
 	}
 	else
 	{
-        for (std::size_t i = wfibs.size() - 1; i >= 0; i--)
+        for (std::size_t i = FindFibreIndex(wfibs, lwp, bedge); i-- > 0; )
 		{
 			if (wfibs[i].wp < lwpend) 
 				break; 
-			if (bedge ? (wfibs[i].wp <= lwp) : (wfibs[i].wp < lwp)) 
-				if (wfibs[i].Contains(lw)) 
-                    return {i};
+			if (wfibs[i].Contains(lw)) 
+                return {i};
 		}
 	}
 
@@ -65,9 +88,10 @@ static maybe<std::size_t> FindInwards(const std::vector<S1>& wfibs, double lw, b
 
 
 //////////////////////////////////////////////////////////////////////
-S2weave::S2weave(const I1& lurg, const I1& lvrg, double res)
- : urg(lurg), vrg(lvrg), ufibs(), vfibs(),
-   firstcontournumber(0), lastcontournumber(firstcontournumber - 1)
+S2weave::S2weave(const I1& lurg, const I1& lvrg, double res, Arena* lparena)
+ : urg(lurg), vrg(lvrg), ufibs(), vfibs(), ufibcs(), vfibcs(),
+   firstcontournumber(0), lastcontournumber(firstcontournumber - 1), cutepoch(0), parena(lparena),
+   nchanges(0), ncellboundschanges(0), cellbounds()
 {
     std::size_t nufib = urg.Leng() / res + 2;
     std::size_t nvfib = vrg.Leng() / res + 2;
@@ -75,11 +99,11 @@ S2weave::S2weave(const I1& lurg, const I1& lvrg, double res)
     // generate the fibres
     ufibs.reserve(nufib);
     for (std::size_t i = 0; i <= nufib; i++)
-        ufibs.emplace_back(urg.Along((double)i / nufib), vrg, S1::Fibre::u);
+        ufibs.emplace_back(urg.Along((double)i / nufib), vrg, S1::Fibre::u, parena);
 
     vfibs.reserve(nvfib);
     for (std::size_t j = 0; j <= nvfib; j++)
-        vfibs.emplace_back(vrg.Along((double)j / nvfib), urg, S1::Fibre::v);
+        vfibs.emplace_back(vrg.Along((double)j / nvfib), urg, S1::Fibre::v, parena);
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -88,10 +112,14 @@ void S2weave::Advance(S2weaveB1iter& al)
 {
 	bool bedge = true; 
 	double wend; 
+	std::size_t iepend; 
 	while (true)
 	{
-        I1 frg = (al.ftype == S2weaveB1iter::Fibre::u ? ufibs : vfibs)[al.ixwp].ContainsRG(al.w);
-		wend = (al.blower ? frg.hi : frg.lo); 
+        const S1& fib = (al.ftype == S2weaveB1iter::Fibre::u ? ufibs : vfibs)[al.ixwp];
+        std::ptrdiff_t ilo = fib.ContainsIndex(al.w);
+        ASSERT(ilo != -1);
+        iepend = ilo + (al.blower ? 1 : 0);
+		wend = fib.ep[iepend].w; 
         auto lixwp = FindInwards((al.ftype == S2weaveB1iter::Fibre::u ? vfibs : ufibs), al.wp, al.blower, al.w, wend, bedge);
 
 		// hit an end.  
@@ -111,6 +139,7 @@ void S2weave::Advance(S2weaveB1iter& al)
 
 	// we've hit an endpoint, go to it and reverse 
 	al.w = wend; 
+	al.iep = iepend; 
 	al.blower = !al.blower; 
 }
 
@@ -134,26 +163,68 @@ void S2weave::TrackContour(std::vector<P2>& pth, S2weaveB1iter al)
 //////////////////////////////////////////////////////////////////////
 int& S2weave::ContourNumber(S2weaveB1iter& al)  
 {
-    S1& wfib = (al.ftype == S2weaveB1iter::Fibre::u ? ufibs : vfibs)[al.ixwp];
-    for (std::size_t i = (al.blower ? 0 : 1); i < wfib.ep.size(); i += 2)
-        if (wfib.ep[i].w == al.w)
-            return wfib.ep[i].contournumber;
-	static int balls = 1; 
-	ASSERT(0); 
-	return balls; 
+    bool bufib = (al.ftype == S2weaveB1iter::Fibre::u);
+    ASSERT(((al.iep % 2) == 0) == al.blower);
+    ASSERT((bufib ? ufibs : vfibs)[al.ixwp].ep[al.iep].w == al.w);
+    return GetB1c(bufib, al.ixwp, al.iep).contournumber; 
 }
 
 //////////////////////////////////////////////////////////////////////
-void S2weave::SetAllCutCodes(int lcutcode)  
+// puts a fibre in between two others, with the side arrays kept in step.  
+// the cells on either side of it become the two halves of the old cell.  
+std::size_t S2weave::InsertFibre(const S1& fib)
 {
-    for (auto& ufib : ufibs)
-        ufib.SetAllCutCodes(lcutcode);
-    for (auto& vfib : vfibs)
-        vfib.SetAllCutCodes(lcutcode);
+    bool bufib = (fib.ftype == S1::Fibre::u);
+    std::vector<S1>& wfibs = (bufib ? ufibs : vfibs);
+    std::vector< std::vector<B1c> >& fibcs = (bufib ? ufibcs : vfibcs);
+
+    std::size_t ix = FindFibreIndex(wfibs, fib.wp, false);
+    ASSERT((ix > 0) && (ix < wfibs.size()) && (wfibs[ix].wp != fib.wp));
+    if (!fibcs.empty())
+    {
+        ASSERT(fibcs.size() == wfibs.size());
+        fibcs.emplace(fibcs.begin() + ix);
+    }
+    Changed();
+    wfibs.emplace(wfibs.begin() + ix, fib.wp, fib.wrg, fib.ftype, parena);
+    wfibs[ix].ep.Mutable().assign(fib.ep.begin(), fib.ep.end());
+    return ix;
+}
+
+//////////////////////////////////////////////////////////////////////
+// the side array follows the endpoints lazily.  Stale values left after 
+// the fibre has been hacked are harmless, since contour numbers below 
+// firstcontournumber count as unvisited and cutcodes below cutepoch as uncut.  
+B1c& S2weave::GetB1c(bool bufib, std::size_t ixwp, std::size_t iep)
+{
+    const std::vector<S1>& wfibs = (bufib ? ufibs : vfibs);
+    std::vector< std::vector<B1c> >& fibcs = (bufib ? ufibcs : vfibcs);
+    if (fibcs.size() != wfibs.size())
+        fibcs.resize(wfibs.size());
+    if (fibcs[ixwp].size() != wfibs[ixwp].ep.size())
+        fibcs[ixwp].resize(wfibs[ixwp].ep.size());
+    ASSERT(iep < wfibs[ixwp].ep.size());
+    return fibcs[ixwp][iep];
+}
+
+//////////////////////////////////////////////////////////////////////
+// bnew is set when the entry is empty and the caller must fill it.  
+S2weaveCellBounds& S2weave::GetCellBounds(std::size_t iu, std::size_t iv, bool& bnew)
+{
+    if (ncellboundschanges != nchanges)
+    {
+        cellbounds.clear();
+        ncellboundschanges = nchanges;
+    }
+    ASSERT((iu < ufibs.size()) && (iv < vfibs.size()));
+    auto res = cellbounds.emplace(iu * vfibs.size() + iv, S2weaveCellBounds());
+    bnew = res.second;
+    return res.first->second;
 }
 
 void S2weave::Invert()
 {
+    Changed();
     for (auto& ufib : ufibs)
         ufib.Invert();
     for (auto& vfib : vfibs)
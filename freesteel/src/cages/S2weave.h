@@ -27,6 +27,7 @@
 #include "cages/PathXSeries.h"
 #include "cages/PathXboxed.h"
 #include <vector>
+#include <unordered_map>
 
 //////////////////////////////////////////////////////////////////////
 // point location which iterates through the weave.  
@@ -44,37 +45,87 @@ struct S2weaveB1iter
     double wp; // perpendicular to fibre.
 
     std::size_t ixwp; // index of fibre
+    std::size_t iep; // index of the endpoint in the fibre, when we're on one.
 
     P2 GetPoint() const;
 }; 
 
 
+//////////////////////////////////////////////////////////////////////
+// index of the first fibre with wp >= lwp, or wp > lwp if bstrict.  
+// guessed from the spacing and corrected, so it's O(1) on a regular weave.  
+std::size_t FindFibreIndex(const std::vector<S1>& wfibs, double lwp, bool bstrict);
+
+
+//////////////////////////////////////////////////////////////////////
+// the endpoints round one cell, as S2weaveCell::CreateBoundList makes them.  
+struct S2weaveCellBounds
+{
+    std::vector< std::pair<std::size_t, const B1*> > boundlist;
+    std::vector< std::pair<std::size_t, std::size_t> > bolistpairs;
+    bool bLDin;
+    bool bLUin;
+    bool bRUin;
+    bool bRDin;
+    std::size_t sidenwrites[4]; // of the cell sides' endpoints when made, in GetSide order
+};
+
+
 //////////////////////////////////////////////////////////////////////
 // this is a general model of a 2D area.  
+// a copy is a snapshot: the fibres share their endpoints with the 
+// original until one side hacks them (see B1cow), while the contour and 
+// cut bookkeeping is its own.  Take copies on the thread that hacks the original.  
 class S2weave 
 {
-    // this will have subdividing capability later.
+    // subdivided by putting in extra fibres between the regular ones.
 public: 
     I1 urg;
     I1 vrg;
 
-    // the fibres
-    // look forward to handling subdividing types.
-    // maybe a bucket between each of the main framework.
+    // the fibres, in increasing wp.  
+    // regularly spaced unless fibres have been inserted.  
     std::vector<S1> ufibs;
     std::vector<S1> vfibs;
+
+    // contouring and cutting bookkeeping running parallel to the endpoints 
+    // of each fibre.  Left empty until contouring asks for it.  
+    std::vector< std::vector<B1c> > ufibcs;
+    std::vector< std::vector<B1c> > vfibcs;
+
     int firstcontournumber; // contour numbers less than this are counted as unvisited.
     int lastcontournumber;
+    int cutepoch; // likewise cutcodes less than this are counted as uncut.
+
+    // where the fibre endpoints are allocated, or null for the heap.  
+    // it must outlive the weave.  
+    Arena* parena;
+
+    // cell bound lists kept for traversals which re-enter cells, keyed by iu * vfibs.size() + iv.  
+    // everything that hacks the fibres must call Changed(), which throws them away; 
+    // an entry whose sides have been written since it was made is asserted on and remade.  
+    // not thread-safe: one traversal at a time per weave.  
+    std::size_t nchanges;
+    std::size_t ncellboundschanges;
+    std::unordered_map<std::size_t, S2weaveCellBounds> cellbounds;
 
     // this is where the path goes
-    S2weave(const I1& urg, const I1& vrg, double res);
+    S2weave(const I1& urg, const I1& vrg, double res, Arena* lparena = nullptr);
 
     // contouring type functions
     void Advance(S2weaveB1iter& al);
     int& ContourNumber(S2weaveB1iter& al);
     void TrackContour(std::vector<P2>& pth, S2weaveB1iter al);
 
-    void SetAllCutCodes(int lcutcode);
+    std::size_t InsertFibre(const S1& fib);
+
+    void Changed() { nchanges++; }
+    S2weaveCellBounds& GetCellBounds(std::size_t iu, std::size_t iv, bool& bnew);
+
+    B1c& GetB1c(bool bufib, std::size_t ixwp, std::size_t iep);
+    void NewCutEpoch() { cutepoch++; } // everything is uncut again
+    bool IsCut(const B1c& c) const { return (c.cutcode >= cutepoch); }
+    void SetCut(B1c& c) const { c.cutcode = cutepoch; }
     void Invert();
 };
 
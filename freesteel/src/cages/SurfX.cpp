@@ -22,16 +22,25 @@
 #include "pits/NormRay_gen.h"
 
 //////////////////////////////////////////////////////////////////////
-void SurfX::SliceFibre(Ray_gen& rgen) const
+template<S1::Fibre ft> static void SliceFibreF(const SurfX& sx, Ray_gen& rgen)
 {
     // points
-    for (auto& p : vdX) rgen.BallSlice(p);
+    for (auto& p : sx.vdX) rgen.BallSliceF<ft>(p);
 
     // edges
-    for (auto& edge : edX) rgen.BallSlice(*(edge.p0), *(edge.p1));
+    for (auto& edge : sx.edX) rgen.BallSliceF<ft>(*(edge.p0), *(edge.p1));
 
     // faces
-    for (auto& tri : trX) rgen.BallSlice(*tri.FirstPoint(), *tri.SecondPoint(), *tri.ThirdPoint());
+    for (auto& tri : sx.trX) rgen.BallSliceF<ft>(*tri.FirstPoint(), *tri.SecondPoint(), *tri.ThirdPoint());
+}
+
+//////////////////////////////////////////////////////////////////////
+void SurfX::SliceFibre(Ray_gen& rgen) const
+{
+    if (rgen.pfib->ftype == S1::Fibre::u)
+        SliceFibreF<S1::Fibre::u>(*this, rgen);
+    else
+        SliceFibreF<S1::Fibre::v>(*this, rgen);
 }
 
 //////////////////////////////////////////////////////////////////////
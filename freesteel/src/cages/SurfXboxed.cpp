@@ -347,18 +347,25 @@ void SurfXboxed::SortBuckets()
 
 
 //////////////////////////////////////////////////////////////////////
-void SurfXboxed::SliceFibreBox(std::size_t iu, std::size_t iv, Ray_gen& rgen)
+template<S1::Fibre ft, class RG> static void SliceBucketF(const bucketX& bu, RG& rgen)
 {
-    bucketX& bu = buckets[iu][iv];
-
     for (auto& p : bu.ckpoints)
-        rgen.BallSlice(*p);
+        rgen.template BallSliceF<ft>(*p);
 
     for (auto& edge : bu.ckedges)
-        rgen.BallSlice(*(edge.edx->p0), *(edge.edx->p1));
+        rgen.template BallSliceF<ft>(*(edge.edx->p0), *(edge.edx->p1));
 
     for (auto& tri : bu.cktriangs)
-        rgen.BallSlice(*tri.trx->FirstPoint(), *tri.trx->SecondPoint(), *tri.trx->ThirdPoint());
+        rgen.template BallSliceF<ft>(*tri.trx->FirstPoint(), *tri.trx->SecondPoint(), *tri.trx->ThirdPoint());
+}
+
+//////////////////////////////////////////////////////////////////////
+void SurfXboxed::SliceFibreBox(std::size_t iu, std::size_t iv, Ray_gen& rgen)
+{
+    if (rgen.pfib->ftype == S1::Fibre::u)
+        SliceBucketF<S1::Fibre::u>(buckets[iu][iv], rgen);
+    else
+        SliceBucketF<S1::Fibre::v>(buckets[iu][iv], rgen);
 }
 
 
@@ -391,7 +398,7 @@ void SurfXboxed::SliceUFibre(Ray_gen& rgen)
                 std::pair<int, int> ivrg = yparts[iu].FindPartRG(vrg);
 
                 for (int iv = ivrg.first; iv <= ivrg.second; iv++)
-                    SliceFibreBox(iu, iv, rgen);
+                    SliceBucketF<S1::Fibre::u>(buckets[iu][iv], rgen);
             }
         }
     }
@@ -427,7 +434,47 @@ void SurfXboxed::SliceVFibre(Ray_gen& rgen)
                 std::pair<int, int> ivrg = yparts[iu].FindPartRG(vrg);
 
                 for (int iv = ivrg.first; iv <= ivrg.second; iv++)
-                    SliceFibreBox(iu, iv, rgen);
+                    SliceBucketF<S1::Fibre::v>(buckets[iu][iv], rgen);
+            }
+        }
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// the boxes are those for the largest ball, which cover all the rest.  
+void SurfXboxed::SliceFibre(MultiRay_gen& mrgen)
+{
+    if (buckets.empty())
+    {
+        for (auto& rgen : mrgen.rgens)
+            psurfx->SliceFibre(rgen);
+        return;
+    }
+
+    const S1* pfib = mrgen.rgens.front().pfib;
+    bool bu = (pfib->ftype == S1::Fibre::u);
+    double r = mrgen.MaxRadius() + searchbox_epsilon;
+    I1 wprg(pfib->wp - r, pfib->wp + r);
+    I1 wrg = pfib->wrg.Inflate(r);
+
+    I1 urg = (bu ? wprg : wrg);
+    if (urg.Intersect(gbxrg))
+    {
+        auto iurg = xpart.FindPartRG(urg);
+        for (auto iu = iurg.first; iu <= iurg.second; iu++)
+        {
+            I1 vrg = (bu ? wrg : wprg);
+            if (vrg.Intersect(gbyrg))
+            {
+                std::pair<int, int> ivrg = yparts[iu].FindPartRG(vrg);
+                for (int iv = ivrg.first; iv <= ivrg.second; iv++)
+                {
+                    if (bu)
+                        SliceBucketF<S1::Fibre::u>(buckets[iu][iv], mrgen);
+                    else
+                        SliceBucketF<S1::Fibre::v>(buckets[iu][iv], mrgen);
+                }
             }
         }
     }
@@ -100,6 +100,7 @@ public:
     void SliceFibreBox(std::size_t iu, std::size_t iv, class Ray_gen& rgen);
     void SliceUFibre(Ray_gen& rgen);
     void SliceVFibre(Ray_gen& rgen);
+    void SliceFibre(class MultiRay_gen& mrgen);
 }; 
 
 
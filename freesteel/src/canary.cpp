@@ -121,12 +121,19 @@ int main(int argc, char* argv[]) {
         params.toolcornerrad = cr;
         params.toolflatrad = fr;
         params.samplestep = 0.4;
+        params.samplestepmax = 0.0;
+        params.samplechordtol = 0.01;
         params.stepdown = sd;
         params.clearcuspheight = sd / 3.0;
 
     // weave parameters
         params.triangleweaveres = 0.51;
         params.flatradweaveres = 0.71;
+        params.weaverefinetol = 0.0;
+        params.weaveresmin = 0.1;
+        params.contoursimplifyfrac = 0.0;
+        params.areaoffsetres = 0.0;
+        params.zsweepband = sd * 2;
 
     // stearing parameters
     // fixed values controlling the step-forward of the tool and
@@ -167,7 +174,19 @@ int main(int argc, char* argv[]) {
             if (link_path < path.GetNbrks())    // No link for last path
             {
                 for (unsigned i = 0; i < path.GetNlnks(link_path); ++i)
-                    std::cout << std::fixed << "G00 " << "X" << path.GetLinkX(link_path, i) << " Y" << path.GetLinkY(link_path, i) << " Z" << path.GetLinkZ(link_path, i) << "\n";
+                {
+                    ArcX arc = (i == 0 ? ArcX() : path.GetLinkArc(link_path, i));
+                    std::cout << std::fixed << (arc.dir == 0 ? "G00 " : (arc.dir == 1 ? "G03 " : "G02 "));
+                    std::cout << "X" << path.GetLinkX(link_path, i) << " Y" << path.GetLinkY(link_path, i) << " Z" << path.GetLinkZ(link_path, i);
+                    if (arc.dir != 0)
+                    {
+                        // centre relative to the start of the arc
+                        std::cout << " I" << (arc.cen.u - path.GetLinkX(link_path, i - 1));
+                        std::cout << " J" << (arc.cen.v - path.GetLinkY(link_path, i - 1));
+                        std::cout << " F" << params.fretract;
+                    }
+                    std::cout << "\n";
+                }
                 ++link_path;
             }
         });
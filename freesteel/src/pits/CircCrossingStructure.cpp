@@ -21,9 +21,96 @@
 #include "CircCrossingStructure.h"
 #include "cages/PathXboxed.h"
 #include "cages/PathXSeries.h"
+#include "cages/BoundXboxed.h"
 #include <utility>
 #include <algorithm>
 
+//////////////////////////////////////////////////////////////////////
+// where the boundary segment b0 to b1 crosses the horizontal ray out from cpt.  
+void CircCrossingStructure::HrayCross(std::vector< std::pair<double, bool> >& hraypara, const P2& b0, const P2& b1) const
+{
+	P2 p0 = b0 - cpt; 
+	P2 p1 = b1 - cpt; 
+
+	// crossing the horizontal axis 
+	if ((p0.v < 0.0) != (p1.v < 0.0))  
+	{
+		double lam = p0.v / (p0.v - p1.v); 
+		TOL_ZERO(Along(lam, p0.v, p1.v)); 
+		double cu = Along(lam, p0.u, p1.u); 
+		if (cu >= 0.0) 
+            hraypara.emplace_back(cu, (p1.v >= 0.0));
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// where the boundary segment b0 to b1 crosses the circle, into cpara.  
+void CircCrossingStructure::CircCross(const P2& b0, const P2& b1) 
+{
+	P2 p0 = b0 - cpt; 
+	double rad0sq = p0.Lensq(); 
+	bool brad0in = (rad0sq < cradsq); 
+	P2 p1 = b1 - cpt; 
+	double rad1sq = p1.Lensq(); 
+	bool brad1in = (rad1sq < cradsq); 
+
+	// discard if inside fully (by convexity).  
+	if (brad0in && brad1in) 
+		return; 
+
+
+	// find closest approach of line 
+	P2 v = p1 - p0; 
+	double vsq = v.Lensq(); 
+	if (vsq == 0.0) 
+		return; 
+
+	// discard if closest is too far.  
+	double cdsq = Square(Dot(p0, APerp(v))) / vsq; 
+	if (cdsq >= cradsq)
+	{
+		// only get away of both endpoints are not in circle.  
+		if ((rad0sq >= cradsq) && (rad1sq >= cradsq)) 
+			return; 
+		TOL_ZERO(std::max(cradsq - rad0sq, cradsq - rad1sq)); 
+	}
+
+	// find lambda of crossing points of line and circle.  
+	double lamz = -Dot(p0, v) / vsq; 
+
+	// discard if outside fully and closest point is beyond  
+	if (!brad0in && !brad1in && !I1unit.Contains(lamz)) 
+		return; 
+
+	TOL_ZERO(cdsq + Square(lamz) * vsq - p0.Lensq()); 
+	double lampsq = (cradsq - cdsq) / vsq; 
+	
+
+	// line may cross the circle.  
+	double lamp = sqrt(lampsq); 
+	TOL_ZERO(AlongD(lamz + lamp, p0, p1).Len() - crad); 
+
+	TOL_ZERO(std::min(I1unit.Distance(lamz + lamp), I1unit.Distance(lamz - lamp))); 
+
+	// lower crossing
+	if (!brad0in) 
+	{
+		double lam = I1unit.PushIntoSmall(lamz - lamp); 
+		P2 rpt = Along(lam, p0, p1); 
+		TOL_ZERO(rpt.Len() - crad); 
+        cpara.emplace_back(rpt, rpt.DArg(), true);
+	}
+	
+	// upper crossing
+	if (!brad1in) 
+	{
+		double lam = I1unit.PushIntoSmall(lamz + lamp); 
+		P2 rpt = Along(lam, p0, p1); 
+		TOL_ZERO(rpt.Len() - crad); 
+        cpara.emplace_back(rpt, rpt.DArg(), false);
+	}
+}
+
 //////////////////////////////////////////////////////////////////////
 // this establishes the circrange
 void CircCrossingStructure::ChopOutBoundary(const std::vector<P2>& bound)  
@@ -42,92 +129,46 @@ void CircCrossingStructure::ChopOutBoundary(const std::vector<P2>& bound)
     std::vector< std::pair<double, bool> > hraypara; // along the horizontal ray (for if wholly in or out).  
 
 	ASSERT(bound.front() == bound.back()); 
-	P2 p1 = bound.front() - cpt; 
-	double rad1sq = p1.Lensq(); 
-	bool bradfirstin = (rad1sq < cradsq); 
-	bool brad1in = bradfirstin; 
-
     for (std::size_t i = 1; i < bound.size(); i++)
 	{
-		// move to next point in contour.  (done here due to the continue commands).  
-		P2 p0 = p1; 
-		double rad0sq = rad1sq; 
-		bool brad0in = brad1in; 
-
-		// the second point
-		p1 = bound[i] - cpt; 
-		rad1sq = p1.Lensq(); 
-		// ensure total consistency  
-		brad1in = (i != bound.size() - 1 ? (rad1sq < cradsq) : bradfirstin); 
-
-		// crossing the horizontal axis 
-		if ((p0.v < 0.0) != (p1.v < 0.0))  
-		{
-			double lam = p0.v / (p0.v - p1.v); 
-			TOL_ZERO(Along(lam, p0.v, p1.v)); 
-			double cu = Along(lam, p0.u, p1.u); 
-			if (cu >= 0.0) 
-                hraypara.emplace_back(cu, (p1.v >= 0.0));
-		}
-
-		// discard if inside fully (by convexity).  
-		if (brad0in && brad1in) 
-			continue; 
-
-
-		// find closest approach of line 
-		P2 v = p1 - p0; 
-		double vsq = v.Lensq(); 
-		if (vsq == 0.0) 
-			continue; 
-
-		// discard if closest is too far.  
-		double cdsq = Square(Dot(p0, APerp(v))) / vsq; 
-		if (cdsq >= cradsq)
-		{
-			// only get away of both endpoints are not in circle.  
-			if ((rad0sq >= cradsq) && (rad1sq >= cradsq)) 
-				continue; 
-			TOL_ZERO(std::max(cradsq - rad0sq, cradsq - rad1sq)); 
-		}
-
-		// find lambda of crossing points of line and circle.  
-		double lamz = -Dot(p0, v) / vsq; 
-
-		// discard if outside fully and closest point is beyond  
-		if (!brad0in && !brad1in && !I1unit.Contains(lamz)) 
-			continue; 
-
-		TOL_ZERO(cdsq + Square(lamz) * vsq - p0.Lensq()); 
-		double lampsq = (cradsq - cdsq) / vsq; 
-		
-
-		// line may cross the circle.  
-		double lamp = sqrt(lampsq); 
-		TOL_ZERO(AlongD(lamz + lamp, p0, p1).Len() - crad); 
+		HrayCross(hraypara, bound[i - 1], bound[i]); 
+		CircCross(bound[i - 1], bound[i]); 
+	}
+	ChopOutCrossings(hraypara); 
+}
 
-		TOL_ZERO(std::min(I1unit.Distance(lamz + lamp), I1unit.Distance(lamz - lamp))); 
+//////////////////////////////////////////////////////////////////////
+// the same from only the segments in the boxes near the circle.  
+void CircCrossingStructure::ChopOutBoundary(const BoundXboxed& boundxb)  
+{
+    std::vector<std::size_t> isegs;
+	boundxb.FindSegs(isegs, cpt, crad); 
+	ChopOutBoundary(boundxb, isegs); 
+}
 
-		// lower crossing
-		if (!brad0in) 
-		{
-			double lam = I1unit.PushIntoSmall(lamz - lamp); 
-			P2 rpt = Along(lam, p0, p1); 
-			TOL_ZERO(rpt.Len() - crad); 
-            cpara.emplace_back(rpt, rpt.DArg(), true);
-		}
-		
-		// upper crossing
-		if (!brad1in) 
-		{
-			double lam = I1unit.PushIntoSmall(lamz + lamp); 
-			P2 rpt = Along(lam, p0, p1); 
-			TOL_ZERO(rpt.Len() - crad); 
-            cpara.emplace_back(rpt, rpt.DArg(), false);
-		}
+//////////////////////////////////////////////////////////////////////
+void CircCrossingStructure::ChopOutBoundary(const BoundXboxed& boundxb, const std::vector<std::size_t>& isegs)  
+{
+    circrange.SetNew(0.0, I1(0, 4), S1::Fibre::circ);
+	if (boundxb.pths.empty())
+	{
+		circrange.Merge(I1(0.0, 4.0)); 
+		return;
 	}
 
+    std::vector< std::pair<double, bool> > hraypara; 
+	ASSERT(boundxb.pths.front() == boundxb.pths.back()); 
+	for (auto i : boundxb.HraySegs(cpt.v))
+		HrayCross(hraypara, boundxb.pths[i - 1], boundxb.pths[i]); 
 
+	for (auto i : isegs)
+		CircCross(boundxb.pths[i - 1], boundxb.pths[i]); 
+	ChopOutCrossings(hraypara); 
+}
+
+//////////////////////////////////////////////////////////////////////
+void CircCrossingStructure::ChopOutCrossings(std::vector< std::pair<double, bool> >& hraypara)  
+{
 	// we now have a series of points in cpara and hraypara
     std::sort(cpara.begin(), cpara.end()); 
     std::sort(hraypara.begin(), hraypara.end()); 
@@ -237,11 +278,9 @@ void CircCrossingStructure::SetPrad(double lprad)
 }
 
 
-static int tccount = 0; 
 //////////////////////////////////////////////////////////////////////
 void CircCrossingStructure::HackToolCircle(const P2& tpt) 
 {
-tccount++; 
 	// maybe subtracting away a region will be better than Merge.  
 	double vsq = tpt.Lensq();
 	if (vsq >= cradppradsq) 
@@ -579,40 +618,92 @@ void HackCCSx(CircCrossingStructure& ccs, const PathXboxed& pathxb)
 {
 	// find conditions where we have to drop through to full-scan  
 	I1 urg(ccs.cpt.u - ccs.cradpprad, ccs.cpt.u + ccs.cradpprad); 
-	if (pathxb.puckets.empty() || (pathxb.bGeoOutLeft && (urg.lo < pathxb.gburg.lo)) || (pathxb.bGeoOutRight && (urg.hi > pathxb.gburg.hi)))  
+	I1 vrg(ccs.cpt.v - ccs.cradpprad, ccs.cpt.v + ccs.cradpprad); 
+	if (!pathxb.BoxesCover(urg, vrg))  
 	{
 		HackCCSx(ccs, *pathxb.ppathx); 
 		return; 
 	}
-	if (!urg.Intersect(pathxb.gburg)) 
-		return; 
 
-	// increment duplicates finder.  
-	pathxb.maxidup++; 
+	// work through the boxes 		
+    std::vector<std::size_t> isegs; 
+	pathxb.FindLines(isegs, urg, vrg); 
+	for (auto iseg : isegs)
+	{
+		P2 p0 = pathxb.ppathx->pths[iseg - 1] - ccs.cpt; 
+		P2 p1 = pathxb.ppathx->pths[iseg] - ccs.cpt; 
+		ccs.HackToolRectangle(p0, p1); 
+		ccs.HackToolCircle(p0); 
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// the boundary segments and toolpath lines in reach of any circle 
+// centred within crad of this one.  
+void CircEngagement::Fill(const CircCrossingStructure& ccs, const BoundXboxed& boundxb, const PathXboxed& pathxb) 
+{
+	cpt = ccs.cpt; 
+	crad = ccs.crad; 
+	prad = ccs.prad; 
+	bfilled = true; 
+	nuses = 0; 
+
+	boundxb.FindSegs(boundsegs, cpt, 2 * crad); 
+
+	// the same conditions as HackCCSx for when the boxes can't be used.  
+	double reach = 2 * crad + prad; 
+	I1 urg(cpt.u - reach, cpt.u + reach); 
+	I1 vrg(cpt.v - reach, cpt.v + reach); 
+	npths = pathxb.ppathx->pths.size(); 
+	bpathscan = !pathxb.BoxesCover(urg, vrg); 
+	pathxb.FindLines(pathsegs, urg, vrg); 
+}
+
+//////////////////////////////////////////////////////////////////////
+// the lines which have come onto the end of the path since it was filled.  
+void CircEngagement::AddNewSegs(const PathXboxed& pathxb) 
+{
+	const PathXSeries& paths = *pathxb.ppathx; 
+	double reach = 2 * crad + prad; 
+	for ( ; npths < paths.pths.size(); npths++) 
+	{
+		// no line into the first point or the one after a break
+		if ((npths == 0) || std::binary_search(paths.brks.begin(), paths.brks.end(), npths)) 
+			continue; 
+		const P2& p0 = paths.pths[npths - 1]; 
+		const P2& p1 = paths.pths[npths]; 
+		if (I1::SCombine(p0.u, p1.u).Inflate(reach).Contains(cpt.u) && I1::SCombine(p0.v, p1.v).Inflate(reach).Contains(cpt.v)) 
+			pathsegs.push_back(npths); 
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void CircEngagement::Hack(CircCrossingStructure& ccs, const BoundXboxed& boundxb, const PathXboxed& pathxb) 
+{
+	if (!bfilled || (nuses >= nrefill) || (ccs.crad != crad) || (ccs.prad != prad) || 
+		((ccs.cpt - cpt).Lensq() > Square(crad)) || (npths > pathxb.ppathx->pths.size())) 
+		Fill(ccs, boundxb, pathxb); 
+	else
+		AddNewSegs(pathxb); 
+	nuses++; 
 
-	// work through the ranges 		
-    auto iurg = pathxb.upart.FindPartRG(urg);
-    for (auto iu = iurg.first; iu <= iurg.second; iu++)
+	ccs.ChopOutBoundary(boundxb, boundsegs); 
+	if (bpathscan) 
 	{
-		const pucketX& pucx = pathxb.puckets[iu]; 
-        for (std::size_t k = 0; k < pucx.cklines.size(); k++)
-		{
-			if ((pucx.cklines[k].idup != -1) || (pucx.cklines[k].idup != pathxb.maxidup))
-			{
-				int iseg = pucx.cklines[k].iseg; 
-				P2 p0 = pathxb.ppathx->pths[iseg - 1] - ccs.cpt; 
-				P2 p1 = pathxb.ppathx->pths[iseg] - ccs.cpt; 
-				ccs.HackToolRectangle(p0, p1); 
-				ccs.HackToolCircle(p0); 
-
-				// mark for duplicates 
-				if (pucx.cklines[k].idup != -1)
-				{
-					ASSERT(pucx.cklines[k].idup < pathxb.maxidup); 
-					pucx.cklines[k].idup = pathxb.maxidup; 
-				}
-			}
-		}
+		HackCCSx(ccs, *pathxb.ppathx); 
+		return; 
+	}
+
+	// as HackCCSx does with the boxes.  
+	for (auto iseg : pathsegs) 
+	{
+		if (ccs.circrange.ep.empty())
+			break; 
+		P2 p0 = pathxb.ppathx->pths[iseg - 1] - ccs.cpt; 
+		P2 p1 = pathxb.ppathx->pths[iseg] - ccs.cpt; 
+		ccs.HackToolRectangle(p0, p1); 
+		ccs.HackToolCircle(p0); 
 	}
 }
 
@@ -620,19 +711,22 @@ void HackCCSx(CircCrossingStructure& ccs, const PathXboxed& pathxb)
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
 // returns a series of points which interfere with the metal along the circumference.  
-void CircleIntersectNew(std::vector<I1>& res, const P2& cpt, double crad, const PathXSeries& bound, const PathXboxed& pathxb, double prad)  
+void CircleIntersectNew(std::vector<I1>& res, const P2& cpt, double crad, const BoundXboxed& boundxb, const PathXboxed& pathxb, double prad, CircEngagement* pengage)  
 {
 	CircCrossingStructure ccs(cpt, crad); 
 
-	// only work on the one boundary for now.  
-	// the boundary must come in as external c-clockwise.  
-	ASSERT(!bound.brks.empty() && (bound.brks[0] == bound.pths.size())); 
-	ccs.ChopOutBoundary(bound.pths); 
-
 	// toolpath hacking.  
 	ccs.SetPrad(prad); 
 
-	HackCCSx(ccs, pathxb); 
+	// only work on the one boundary for now.  
+	// the boundary must come in as external c-clockwise.  
+	if (pengage != nullptr) 
+		pengage->Hack(ccs, boundxb, pathxb); 
+	else
+	{
+		ccs.ChopOutBoundary(boundxb); 
+		HackCCSx(ccs, pathxb); 
+	}
 
 	// convert this into a range of Dargs that model the material.  
     if (ccs.circrange.ep.empty())
@@ -26,9 +26,11 @@
 #include "bolts/I1.h"
 #include "bolts/smallfuncs.h"
 #include <vector>
+#include <utility>
 
 class PathXSeries;
 class PathXboxed;
+class BoundXboxed;
 
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
@@ -68,6 +70,11 @@ struct CircCrossingStructure
 
 	// should be a set of boundaries 
 	void ChopOutBoundary(const std::vector<P2>& bound); // creates circrange
+	void ChopOutBoundary(const BoundXboxed& boundxb); 
+	void ChopOutBoundary(const BoundXboxed& boundxb, const std::vector<std::size_t>& isegs); // from the boundary segments isegs 
+	void HrayCross(std::vector< std::pair<double, bool> >& hraypara, const P2& b0, const P2& b1) const; 
+	void CircCross(const P2& b0, const P2& b1); 
+	void ChopOutCrossings(std::vector< std::pair<double, bool> >& hraypara); 
 
     std::vector<CPara> cpara; // around the circle
 
@@ -85,7 +92,38 @@ struct CircCrossingStructure
 
 
 //////////////////////////////////////////////////////////////////////
-void CircleIntersectNew(std::vector<I1>& res, const P2& cpt, double crad, const PathXSeries& bound, const PathXboxed& pathxb, double prad);
+// the boundary and toolpath segments which can reach circles centred within 
+// crad of cpt, carried from one tool position to the next.  the toolpath 
+// segments added since are checked as they come, and the lot is found 
+// again when the circle moves out of range or after nrefill uses.  
+class CircEngagement
+{
+public: 
+	P2 cpt; 
+	double crad; 
+	double prad; 
+	bool bfilled; 
+	int nuses; 
+	static const int nrefill = 64; 
+
+	std::vector<std::size_t> boundsegs; 
+	bool bpathscan; // the path has gone off its boxes here, so scan it all
+	std::size_t npths; // the path points there were when filled
+	std::vector<std::size_t> pathsegs; // the segments ending at these points
+
+	CircEngagement()
+		: crad(0.0), prad(0.0), bfilled(false), nuses(0), bpathscan(false), npths(0)
+	{}
+
+	void Hack(CircCrossingStructure& ccs, const BoundXboxed& boundxb, const PathXboxed& pathxb); 
+
+private: 
+	void Fill(const CircCrossingStructure& ccs, const BoundXboxed& boundxb, const PathXboxed& pathxb); 
+	void AddNewSegs(const PathXboxed& pathxb); 
+}; 
+
+//////////////////////////////////////////////////////////////////////
+void CircleIntersectNew(std::vector<I1>& res, const P2& cpt, double crad, const BoundXboxed& boundxb, const PathXboxed& pathxb, double prad, CircEngagement* pengage = nullptr);
 
 #endif
 
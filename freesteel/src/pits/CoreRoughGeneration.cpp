@@ -21,64 +21,87 @@
 
 #include "CoreRoughGeneration.h"
 #include "CircCrossingStructure.h"
+#include "bolts/threadfuncs.h"
+#include <memory>
 
 /////////////////////////////////////////////////////////// 
 std::vector<PathXSeries> MakeCorerough(SurfX& sx, const PathXSeries& bound, const MachineParams& params)
 {
-    std::vector<PathXSeries> vpathseries;
-
 	// boxed surfaces 
     SurfXboxed sxb(&sx, 10.0);
 
 	// interior close to tool, or absolute intersections with triangle faces
 	double areaoversize = (params.toolcornerrad + params.toolflatrad) * 2 + 13; 
 
-    Area2_gen a2g(sx.gxrg.Inflate(areaoversize), sx.gyrg.Inflate(areaoversize), params.triangleweaveres, &sxb, params.toolcornerrad);
+    // all the fibre endpoints come from here, and go in one go at the end.  
+    Arena weavearena;
+
+    Area2_gen a2g(sx.gxrg.Inflate(areaoversize), sx.gyrg.Inflate(areaoversize), params.triangleweaveres, &sxb, params.toolcornerrad, &weavearena);
+    if (params.zsweepband != 0.0)
+        a2g.BuildZsweep(params.zsweepband);
 
-    Area2_gen a2gfl(sx.gxrg.Inflate(areaoversize), sx.gyrg.Inflate(areaoversize), params.flatradweaveres);
+    Area2_gen a2gfl(sx.gxrg.Inflate(areaoversize), sx.gyrg.Inflate(areaoversize), params.flatradweaveres, &weavearena);
 
+	// the slicing goes on down the levels here, leaving a snapshot of 
+	// the material weave at each for its roughing to run on.  
+    std::vector< std::unique_ptr<Area2_gen> > levelwves;
 	double hz = sx.gzrg.hi - params.stepdown / 2; 
     double htopz = sx.gzrg.lo;
 	a2g.z = sx.gzrg.hi - params.stepdown / 2;
 	while (hz > htopz)
 	{
-        vpathseries.emplace_back();
-		// make the core roughing algorithm thing
-		CoreRoughGeneration crg(&vpathseries.back(), sx.gxrg.Inflate(10), sx.gyrg.Inflate(10)); 
-
-		// the stock boundary 
-		crg.tsbound.Append(bound.pths); 
-
-		// the material boundary weave used in the core roughing.  
-		crg.pa2gg = (params.toolflatrad != 0.0 ? &a2gfl : &a2g); 
-		crg.trad = params.toolcornerrad * 0.9 + params.toolflatrad; // the clearing radius 
-		crg.wc.ps2w = crg.pa2gg; 
-
 		PathXSeries blpaths;
 
 		// hack against the surfaces 
 		a2g.HackDowntoZ(hz); 
-		a2g.MakeContours(blpaths); 
+		a2g.Refine(params.weaverefinetol, params.weaveresmin); 
+		a2g.MakeContours(blpaths, params.contoursimplifyfrac * params.triangleweaveres); 
 
 		// hack by the flatrad.  
 		if (params.toolflatrad != 0.0) 
 		{
-			HackAreaOffset(a2gfl, blpaths, params.toolflatrad); 
+			if (params.areaoffsetres != 0.0) 
+				HackAreaOffsetField(a2gfl, blpaths, params.toolflatrad, params.areaoffsetres); 
+			else
+				HackAreaOffset(a2gfl, blpaths, params.toolflatrad); 
 			a2gfl.z = a2g.z; 
-
-			// make it again so we can see
-			blpaths = PathXSeries(); 
-			a2gfl.MakeContours(blpaths); 
 		}
 
-		crg.GrabberAlg(params); 
-
-
-//		vpathseries.push_back(blpaths);
-//break;
+		// the material boundary weave used in the core roughing.  
+		levelwves.emplace_back(new Area2_gen((params.toolflatrad != 0.0 ? a2gfl : a2g).Snapshot())); 
 		hz -= params.stepdown; 
 	}
 
+	// the stock boundary boxed at about the clearing circle size, 
+	// only read by the levels so shared between them.  
+	// the boundary must come in as a single contour.  
+	ASSERT(!bound.brks.empty() && (bound.brks[0] == bound.pths.size())); 
+	double trad = params.toolcornerrad * 0.9 + params.toolflatrad; // the clearing radius 
+	BoundXboxed boundxb(bound.pths, 2 * trad); 
+
+	// each level writes only to its own path and snapshot, so 
+	// they can be roughed on separate threads and stay in order.  
+    std::vector<PathXSeries> vpathseries(levelwves.size());
+	ParallelFor(levelwves.size(), 1, [&](std::size_t i0, std::size_t i1)
+	{
+		for (std::size_t i = i0; i < i1; i++)
+		{
+			// make the core roughing algorithm thing
+			CoreRoughGeneration crg(&vpathseries[i], sx.gxrg.Inflate(10), sx.gyrg.Inflate(10)); 
+
+			// the stock boundary 
+			crg.tsbound.Append(bound.pths); 
+			crg.ptsboundxb = &boundxb; 
+
+			crg.pa2gg = levelwves[i].get(); 
+			crg.trad = trad; 
+			crg.wc.ps2w = crg.pa2gg; 
+
+			crg.GrabberAlg(params); 
+			levelwves[i].reset(); 
+		}
+	}); 
+
     return vpathseries;
 }
 
@@ -97,64 +120,89 @@ void CoreRoughGeneration::AddPoint(const P2& ppt)
 
 
 /////////////////////////////////////////////////////////// 
-static void BuildRetract(std::vector<P3>& lnkpth, const P3& pts, const P3& pte, const MachineParams& params)
+// a link in the plane, with the arc into each point kept alongside.  
+struct LinkX
+{
+    std::vector<P2> pts;
+    std::vector<ArcX> arcs;
+
+	void Add(const P2& pt, const ArcX& arc = ArcX())
+	{
+		pts.push_back(pt);
+		arcs.push_back(arc);
+	}
+
+	// arcs which come round to where they started are left out.  
+	void AddArc(const P2& pt, const P2& cen, const MachineParams& params)
+	{
+		if ((pt - pts.back()).Len() > 0.001 * params.leadoffsamplestep)
+			Add(pt, ArcX(cen, 1));
+	}
+
+	double SegLen(std::size_t i) const
+	{
+		return arcs[i].Len(pts[i - 1], pts[i]);
+	}
+
+	// chords of the arcs for following through the weave, 
+	// every step round from the start of each arc and then its end.  
+	void Sample(std::vector<P2>& res, double step) const
+	{
+		res.push_back(pts[0]);
+		for (std::size_t i = 1; i < pts.size(); ++i)
+		{
+			double lenseg = (arcs[i].dir == 0 ? 0.0 : SegLen(i));
+			for (double s = step; s < lenseg; s += step)
+				res.push_back(arcs[i].Along(s / lenseg, pts[i - 1], pts[i]));
+			res.push_back(pts[i]);
+		}
+	}
+};
+
+/////////////////////////////////////////////////////////// 
+static void BuildRetract(std::vector<P3>& lnkpth, std::vector<ArcX>& lnkarcs, const P3& pts, const P3& pte, const MachineParams& params)
 {
 	ASSERT((params.retractzheight > pts.z) && (params.retractzheight > pte.z));
-	lnkpth.push_back(pts);
+	if (lnkpth.empty() || !(lnkpth.back() == pts))
+	{
+		lnkpth.push_back(pts);
+		lnkarcs.emplace_back();
+	}
 	lnkpth.push_back(ConvertCZ(pts, params.retractzheight));
 	lnkpth.push_back(ConvertCZ(pte, params.retractzheight));
 	lnkpth.push_back(pte);
+	lnkarcs.resize(lnkpth.size());
 }
 
 /////////////////////////////////////////////////////////// 
-static void BuildCurl(std::vector<P2>& lnkpth, const P2& pts, const P2& dirs, const MachineParams& params, bool bCurlIn)
+// a single arc of leadofflen turning away from the path.  
+static void BuildCurl(LinkX& lnk, const P2& pts, const P2& dirs, const MachineParams& params, bool bCurlIn)
 {
 	TOL_ZERO(dirs.Len() - 1.0);
 
-	double asradstep = params.leadoffsamplestep / params.leadoffrad;
-
 	// centre
 	P2 cts = pts + APerp(dirs) * params.leadoffrad;
 	double adiff = params.leadofflen / params.leadoffrad;
-	double ae, as;
+	double a = (cts - pts).Arg();
 	if (bCurlIn)
 	{
-		ae = (cts - pts).Arg();
-		as = ae - adiff;;
+		lnk.Add(cts - P2(cos(a - adiff), sin(a - adiff)) * params.leadoffrad);
+		lnk.Add(pts, ArcX(cts, 1));
 	}
 	else
 	{
-		as = (cts - pts).Arg();
-		ae = as + adiff;
-	}
-	
-
-	P2 pt = cts - P2(cos(as), sin(as)) * params.leadoffrad;
-	lnkpth.push_back(pt);
-	as += asradstep;
-	while (true)
-	{
-		P2 ptnew = cts - P2(cos(as), sin(as)) * params.leadoffrad;
-		if (as > ae)
-		{
-			P2 ptlast = cts - P2(cos(ae), sin(ae)) * params.leadoffrad;
-			lnkpth.push_back(ptlast);
-			break;
-		}
-
-		lnkpth.push_back(ptnew);
-		pt = ptnew;
-		as += asradstep;
+		lnk.Add(pts);
+		lnk.Add(cts - P2(cos(a + adiff), sin(a + adiff)) * params.leadoffrad, ArcX(cts, 1));
 	}
 }
 
-static void BuildLink(std::vector<P2>& lnkpth, const P2& pts, const P2& dirs, const P2& pte, const P2& dire, const MachineParams& params)
+/////////////////////////////////////////////////////////// 
+// round the start arc to its tangent with the end arc, across and round that.  
+static void BuildLink(LinkX& lnk, const P2& pts, const P2& dirs, const P2& pte, const P2& dire, const MachineParams& params)
 {
 	TOL_ZERO(dirs.Len() - 1.0);
 	TOL_ZERO(dire.Len() - 1.0);
 
-	double asradstep = params.leadoffsamplestep / params.leadoffrad;
-
 	// centre
 	P2 cts = pts + APerp(dirs) * params.leadoffrad;
 	P2 cte = pte + APerp(dire) * params.leadoffrad;
@@ -168,116 +216,47 @@ static void BuildLink(std::vector<P2>& lnkpth, const P2& pts, const P2& dirs, co
 	P2 tps = cts - tdirp;
 	P2 tpe = dire == P2(0, 0) ? pte : (cte - tdirp);
 
-	// loop from start point to tangent point
-	double as = (cts - pts).Arg();
-	if (as > M2PI)
-		as -= M2PI;
-	double at = (cts - tps).Arg();
-	if (at > M2PI)
-		at -= M2PI;
-	if (as > at)
-		at += M2PI;
-
-	while (as <= at)
-	{
-		P2 pt = cts - P2(cos(as), sin(as)) * params.leadoffrad;
-		lnkpth.push_back(pt);
-		as += asradstep;
-	}
-	if (lnkpth.back() != tps)
-		lnkpth.push_back(tps);
-
-	// loop from tangent point to end point
+	lnk.Add(pts);
+	lnk.AddArc(tps, cts, params);
+	if (lnk.pts.back() != tpe)
+		lnk.Add(tpe);
 	if (dire != P2(0, 0))
-	{
-		as = (cte - tpe).Arg();
-		if (as > M2PI)
-			as -= M2PI;
-		at = (cte - pte).Arg();
-		if (at > M2PI)
-			at -= M2PI;
-		if (as > at)
-			at += M2PI;
-
-		while(as <= at)
-		{
-			lnkpth.push_back(cte - P2(cos(as), sin(as)) * params.leadoffrad);
-			as += asradstep;
-		}
-	}
-	if (lnkpth.back() != pte)
-		lnkpth.push_back(pte);
+		lnk.AddArc(pte, cte, params);
 }
 
-static void BuildLinkZ(std::vector<P3>& lnkpth, const std::vector<P2>& lnk2D, double z, const MachineParams& params)
+/////////////////////////////////////////////////////////// 
+// rise by leadoffdz over the first leadofflen and fall over the last, 
+// splitting the pieces where the ramps meet the top.  
+static void BuildLinkZ(std::vector<P3>& lnkpth, std::vector<ArcX>& lnkarcs, const LinkX& lnk, double z, const MachineParams& params)
 {
 	// total length
 	double totallen = 0;
-    for (std::size_t ix = 1; ix < lnk2D.size(); ++ix)
-		totallen += (lnk2D[ix] - lnk2D[ix - 1]).Len();
+    for (std::size_t ix = 1; ix < lnk.pts.size(); ++ix)
+		totallen += lnk.SegLen(ix);
 
-	double leadofflen = params.leadofflen;
-	if (totallen < (2.0 * params.leadofflen))
-		leadofflen = 0.5 * totallen;
+	double leadofflen = std::min(params.leadofflen, 0.5 * totallen);
+	double sbrk[2] = { leadofflen, totallen - leadofflen };
+	auto zalong = [&](double s) { return z + params.leadoffdz * std::min(1.0, std::min(s, totallen - s) / leadofflen); };
 
-    std::vector<P3> lnkStart;
-    std::size_t ixstart = 1;
+	lnkpth.push_back(ConvertGZ(lnk.pts[0], z));
+	lnkarcs.emplace_back();
 	double len = 0;
-	lnkStart.push_back(ConvertGZ(lnk2D[0], z));
-	while (ixstart < lnk2D.size())
-	{
-		len += (lnk2D[ixstart] - lnk2D[ixstart - 1]).Len();
-		if (len > leadofflen)
-			break;
-
-		double dz = len * params.leadoffdz / leadofflen;
-		lnkStart.push_back(ConvertGZ(lnk2D[ixstart], z + dz));
-		++ixstart;
-	}
-	ASSERT((lnkStart.back().z > z) && (lnkStart.back().z <= params.leadoffdz + z));
-	if (ixstart < lnk2D.size())
-	{
-		len += (lnk2D[ixstart] - lnk2D[ixstart - 1]).Len();
-		double dz = len * params.leadoffdz / leadofflen;
-		double lam = params.leadoffdz / dz;
-		P2 pt = Along(lam, lnk2D[ixstart - 1], lnk2D[ixstart]);
-		lnkStart.push_back(ConvertGZ(pt, z + params.leadoffdz));
-	}
-
-    std::vector<P3> lnkEnd;
-	int ixend = lnk2D.size() - 2;
-	len = 0;
-	lnkEnd.push_back(ConvertGZ(lnk2D.back(), z));
-	while (ixend > ixstart)
+    for (std::size_t ix = 1; ix < lnk.pts.size(); ++ix)
 	{
-		len += (lnk2D[ixend] - lnk2D[ixend + 1]).Len();
-		if (len > leadofflen)
-			break;
-
-		double dz = len * params.leadoffdz / leadofflen;
-		lnkEnd.push_back(ConvertGZ(lnk2D[ixend], z + dz));
-		--ixend;
-	}
-	ASSERT((lnkEnd.back().z > z) && (lnkEnd.back().z <= params.leadoffdz + z));
-	if (ixend >= ixstart)
-	{
-		len += (lnk2D[ixend] - lnk2D[ixend + 1]).Len();
-		double dz = len * params.leadoffdz / leadofflen;
-		double lam = params.leadoffdz / dz;
-		P2 pt = Along(lam, lnk2D[ixend + 1], lnk2D[ixend]);
-		lnkEnd.push_back(ConvertGZ(pt, z + params.leadoffdz));
+		double lenseg = lnk.SegLen(ix);
+		for (int ib = 0; ib < 2; ++ib)
+		{
+			if ((len < sbrk[ib]) && (sbrk[ib] < len + lenseg) && ((ib == 0) || (sbrk[1] != sbrk[0])))
+			{
+				P2 pt = lnk.arcs[ix].Along((sbrk[ib] - len) / lenseg, lnk.pts[ix - 1], lnk.pts[ix]);
+				lnkpth.push_back(ConvertGZ(pt, zalong(sbrk[ib])));
+				lnkarcs.push_back(lnk.arcs[ix]);
+			}
+		}
+		len += lenseg;
+		lnkpth.push_back(ConvertGZ(lnk.pts[ix], zalong(len)));
+		lnkarcs.push_back(lnk.arcs[ix]);
 	}
-
-	// now put it all together
-	lnkpth.insert(lnkpth.end(), lnkStart.begin(), lnkStart.end());
-
-	int ie;
-	for (ie = ixstart; ie <= ixend; ++ie)
-		lnkpth.push_back(ConvertGZ(lnk2D[ie], (z + params.leadoffdz)));
-
-	ie = lnkEnd.size() - 1;
-	while (ie >= 0)
-		lnkpth.push_back(lnkEnd[ie--]);
 }
 
 
@@ -308,12 +287,12 @@ int CoreRoughGeneration::TrackLink(const std::vector<P2>& lnk2D, S2weaveCellLine
 			while ((len > params.leadoffsamplestep) && res.empty())
 			{
 				pt = pt + nvec * params.leadoffsamplestep;
-				CircleIntersectNew(res, pt, trad, tsbound, pathxb, trad); 
+				CircleIntersectNew(res, pt, trad, *ptsboundxb, pathxb, trad, &engage); 
 				len -= params.leadoffsamplestep;
 			}
 
 			if (res.empty())
-				CircleIntersectNew(res, lnk2D[ix], trad, tsbound, pathxb, trad); 
+				CircleIntersectNew(res, lnk2D[ix], trad, *ptsboundxb, pathxb, trad, &engage); 
 			if (!res.empty())
 			{
 				bOnStock = true;
@@ -327,12 +306,43 @@ int CoreRoughGeneration::TrackLink(const std::vector<P2>& lnk2D, S2weaveCellLine
 	return lnk2D.size();
 }
 
+/////////////////////////////////////////////////////////// 
+// the bearing turned by dch (relative to apvb) for each samplestep 
+// of a step which is ratio samplesteps long.  
+static P2 TurnBearing(const P2& vbearing, const P2& apvb, double dch, double ratio)
+{
+	if (ratio == 1.0) 
+	{
+		P2 Nvbearing = vbearing + apvb * dch; 
+		return Nvbearing / Nvbearing.Len(); 
+	}
+	double ang = atan(dch) * ratio; 
+	return vbearing * cos(ang) + apvb * sin(ang); 
+}
+
+/////////////////////////////////////////////////////////// 
+// the next step length, growing on steady engagement and shrinking 
+// so the arc we turn through (at the present rate or the rate it has 
+// changed by) stays within samplechordtol of its chord.  
+static double AdaptStep(double step, double dch, double dchprev, const MachineParams& params)
+{
+	if (params.samplestepmax <= params.samplestep) 
+		return params.samplestep; 
+
+	// angle turned per samplestep, and the sagitta is len^2 * ang / (8 samplestep)
+	double ang = std::max(fabs(atan(dch)), fabs(atan(dch) - atan(dchprev))); 
+	double res = std::min(step * 2, params.samplestepmax); 
+	if (ang != 0.0) 
+		res = std::min(res, sqrt(8 * params.samplechordtol * params.samplestep / ang)); 
+	return std::max(res, params.samplestep); 
+}
+
 /////////////////////////////////////////////////////////// 
 void CoreRoughGeneration::GrabberAlg(const MachineParams& params)
 {
 	// Generate the toolpath thing 
 	countfreespacesteps = 0; 
-	pa2gg->SetAllCutCodes(-1);   
+	pa2gg->NewCutEpoch();   
 	FindGoStart(); 
 	
 	// put the first position in into our set of links, 
@@ -347,6 +357,7 @@ void CoreRoughGeneration::GrabberAlg(const MachineParams& params)
 	{
 		// track along happily until we reach an ending of some sort 
 		double dch = (wc.bOnContour ? -params.dchangrightoncontour: 0.0); 
+		double step = params.samplestep; 
 		while (true)
 		{
 			// too far in free space, find what's happened
@@ -364,11 +375,12 @@ void CoreRoughGeneration::GrabberAlg(const MachineParams& params)
 
 			// the point we are at currently  
 			P2 ppt = wc.ptcp; 
+			bool bWasOnContour = wc.bOnContour; 
 
 			// move along to next point 
 			if (wc.bOnContour)
 			{
-				if (!wc.OnContourFollowBearing(dch, params.samplestep)) 
+				if (!wc.OnContourFollowBearing(dch, step)) 
 				{
 					// if we are curving in then revert to straight line 
 					if (dch <= 0.0) 
@@ -397,9 +409,7 @@ void CoreRoughGeneration::GrabberAlg(const MachineParams& params)
 				// change direction and then follow along.  
 				// dch is relative to apvb 
 				ASSERT(APerp(wc.vbearing) == wc.apvb); 
-				P2 Nvbearing = wc.vbearing + wc.apvb * dch; 
-	
-				wc.FollowBearing(Nvbearing / Nvbearing.Len(), params.samplestep); 
+				wc.FollowBearing(TurnBearing(wc.vbearing, wc.apvb, dch, step / params.samplestep), step); 
 			}
 				
 
@@ -410,11 +420,11 @@ void CoreRoughGeneration::GrabberAlg(const MachineParams& params)
 			if (wc.bOnContour) 
 			{
 				// we're on a contour; has it already been cleared?  
-				int ibl = wc.bolistpairs[wc.ib].second; 
+				int ibl = wc.pcb->bolistpairs[wc.ib].second; 
 				ASSERT(wc.GetBoundLower(ibl)); 
 
 				// it has, so end this path now.  
-				if (wc.boundlist[ibl].second->cutcode != -1) 
+				if (pa2gg->IsCut(wc.GetBoundB1c(ibl))) 
 				{
 					pathxb.Add(wc.ptcp); 
 					break; 
@@ -422,7 +432,15 @@ void CoreRoughGeneration::GrabberAlg(const MachineParams& params)
 			}
 
 			// change direction according to the amount of material cutting.  
+			double dchprev = dch; 
 			dch = ChangeBearing(wc.ptcp, wc.vbearing, params); 
+
+			// back to the short step in free space, at breakthroughs 
+			// and on or off the contour, where the steering is coarse.  
+			if ((countfreespacesteps != 0) || bPrevPointDoubleRange || (bWasOnContour != wc.bOnContour)) 
+				step = params.samplestep; 
+			else 
+				step = AdaptStep(step, dch, dchprev, params); 
 		}
 
 		wclink = wc; 
@@ -445,14 +463,16 @@ void CoreRoughGeneration::GrabberAlg(const MachineParams& params)
 
 		// need to build a linking motion from wclink.ptcp to wc.ptcp
 		// S2weaveCellLinearCutTraverse wclink = wc; 
-        std::vector<P2> lnk2D;
 		P2 ptOut = wclink.ptcp;
 		P2 drOut = wclink.vbearing;
 		P2 ptIn = wc.ptcp;
 		P2 drIn = wc.vbearing;
 		if (drIn == P2(0, 0))
 			drIn = P2(0, 1.0);
-		BuildLink(lnk2D, ptOut, drOut, ptIn, drIn, params);
+		LinkX lnk;
+		BuildLink(lnk, ptOut, drOut, ptIn, drIn, params);
+        std::vector<P2> lnk2D;
+		lnk.Sample(lnk2D, params.leadoffsamplestep);
 
 		// test link, returns how far we could track along 
 		// link until we make contact with contours or stock
@@ -460,48 +480,44 @@ void CoreRoughGeneration::GrabberAlg(const MachineParams& params)
 
 		ASSERT(pathxb.ppathx->linkpths.size() == pathxb.ppathx->brks.size()); 
         std::vector<P3>& lnkpth = pathxb.ppathx->linkpths.back();
+        std::vector<ArcX>& lnkarcs = pathxb.ppathx->linkarcs.back();
 		if (itracked < (int)lnk2D.size()) 
 		{
 			// retract, but try using curls
-            std::vector<P2> curlout;
+			LinkX curlout;
 			BuildCurl(curlout, ptOut, drOut, params, false);
-			int resout = TrackLink(curlout, wclink, false, params);
-			bool bUseOut = (resout == (int)curlout.size()); 
+            std::vector<P2> curlout2D;
+			curlout.Sample(curlout2D, params.leadoffsamplestep);
+			int resout = TrackLink(curlout2D, wclink, false, params);
+			bool bUseOut = (resout == (int)curlout2D.size()); 
 
-            std::vector<P2> curlin;
+			LinkX curlin;
 			BuildCurl(curlin, ptIn, drIn, params, true);
-			int resin = TrackLink(curlin, wc, true, params);
-			bool bUseIn = (resin == (int)curlin.size()); 
+            std::vector<P2> curlin2D;
+			curlin.Sample(curlin2D, params.leadoffsamplestep);
+			int resin = TrackLink(curlin2D, wc, true, params);
+			bool bUseIn = (resin == (int)curlin2D.size()); 
 
-			P3 ptStartRetract = bUseOut ? ConvertGZ(curlout.back(), pathxb.ppathx->z + params.leadoffdz) : ConvertGZ(wclink.ptcp, pathxb.ppathx->z);
-			P3 ptEndRetract = bUseIn ? ConvertGZ(curlin.front(), pathxb.ppathx->z + params.leadoffdz) : ConvertGZ(wc.ptcp, pathxb.ppathx->z);
+			P3 ptStartRetract = bUseOut ? ConvertGZ(curlout.pts.back(), pathxb.ppathx->z + params.leadoffdz) : ConvertGZ(wclink.ptcp, pathxb.ppathx->z);
+			P3 ptEndRetract = bUseIn ? ConvertGZ(curlin.pts.front(), pathxb.ppathx->z + params.leadoffdz) : ConvertGZ(wc.ptcp, pathxb.ppathx->z);
 
+			// the curls climb as helices
 			if (bUseOut)
 			{
-				double z = pathxb.ppathx->z;
-				double zstep = params.leadoffsamplestep * params.leadoffdz / params.leadofflen;
-				for (int is = 0; is < (int)curlout.size() - 1; ++is)
-				{
-					lnkpth.push_back(ConvertGZ(curlout[is], z));
-					z += zstep;
-				}
-				lnkpth.push_back(ConvertGZ(curlout.back(), pathxb.ppathx->z + params.leadoffdz));
+				lnkpth.push_back(ConvertGZ(curlout.pts.front(), pathxb.ppathx->z));
+				lnkarcs.emplace_back();
+				lnkpth.push_back(ptStartRetract);
+				lnkarcs.push_back(curlout.arcs.back());
 			}
-			BuildRetract(lnkpth, ptStartRetract, ptEndRetract, params);
+			BuildRetract(lnkpth, lnkarcs, ptStartRetract, ptEndRetract, params);
 			if (bUseIn)
 			{
-				double z = pathxb.ppathx->z + params.leadoffdz;
-				double zstep = params.leadoffsamplestep * params.leadoffdz / params.leadofflen;
-				for (int ie = 0; ie < curlin.size() - 1; ++ie)
-				{
-					lnkpth.push_back(ConvertGZ(curlin[ie], z));
-					z -= zstep;
-				}
-				lnkpth.push_back(ConvertGZ(curlin.back(), pathxb.ppathx->z));
+				lnkpth.push_back(ConvertGZ(curlin.pts.back(), pathxb.ppathx->z));
+				lnkarcs.push_back(curlin.arcs.back());
 			}
 		}
 		else
-			BuildLinkZ(lnkpth, lnk2D, pathxb.ppathx->z, params);
+			BuildLinkZ(lnkpth, lnkarcs, lnk, pathxb.ppathx->z, params);
 
 		// we've connected to the start
 		if (bcellixs.empty()) 
@@ -516,7 +532,7 @@ bool CoreRoughGeneration::RestartAtBCI(BCellIndex& bci, const MachineParams& par
 	wc.iu = bci.iu; 
 	wc.iv = bci.iv; 
 	wc.ConstructCellBounds(); 
-	wc.CreateBoundList(); 
+	wc.LoadBoundList(); 
 
 	wc.ib = bci.ib; 
 	if (bci.ib != -1)  
@@ -526,11 +542,11 @@ bool CoreRoughGeneration::RestartAtBCI(BCellIndex& bci, const MachineParams& par
 		wc.bContouribfvisited = true; 
 
 		wc.lambb = 0.0; 
-		int ibl = wc.bolistpairs[wc.ib].first; 
+		int ibl = wc.pcb->bolistpairs[wc.ib].first; 
 		ASSERT(!wc.GetBoundLower(ibl)); 
 		wc.ptcpbb = wc.GetBoundPoint(ibl); 
 
-		P2 Nvbearing = wc.GetBoundPoint(wc.bolistpairs[wc.ib].second) - wc.GetBoundPoint(ibl); 
+		P2 Nvbearing = wc.GetBoundPoint(wc.pcb->bolistpairs[wc.ib].second) - wc.GetBoundPoint(ibl); 
 		wc.vbearing = Nvbearing / Nvbearing.Len(); 
 
 		wc.ptcp = wc.ptcpbb; 
@@ -546,7 +562,7 @@ bool CoreRoughGeneration::RestartAtBCI(BCellIndex& bci, const MachineParams& par
 		// check if this point is really going into new stuff.  
 		P2 tept = wc.ptcp + wc.vbearing * params.samplestep; 
         std::vector<I1> lccpath; 
-		CircleIntersectNew(lccpath, tept, trad, tsbound, pathxb, trad); 
+		CircleIntersectNew(lccpath, tept, trad, *ptsboundxb, pathxb, trad, &engage); 
 		if (!bConnectAtStart) 
 		{
 			if (lccpath.empty()) 
@@ -566,7 +582,7 @@ bool CoreRoughGeneration::RestartAtBCI(BCellIndex& bci, const MachineParams& par
 
 /////////////////////////////////////////////////////////// 
 CoreRoughGeneration::CoreRoughGeneration(PathXSeries* px, const I1& lxrg, const I1& lyrg) : 
-    machxrg(lxrg), machyrg(lyrg), pathxb(px, machxrg, 2.0)
+    machxrg(lxrg), machyrg(lyrg), ptsboundxb(nullptr), pathxb(px, machxrg, machyrg, 2.0)
 {
 }
 
@@ -605,7 +621,7 @@ double CoreRoughGeneration::ChangeBearing(const P2& pt, const P2& ltvec, const M
 
 	// find the part of the tool which is touching the stock.  
     std::vector<I1> lccpath; 
-	CircleIntersectNew(lccpath, pt, trad, tsbound, pathxb, trad); 
+	CircleIntersectNew(lccpath, pt, trad, *ptsboundxb, pathxb, trad, &engage); 
 	ASSERT(lccpath.empty() || ((lccpath.front().lo == 0.0) == (lccpath.back().hi == 4.0))); 
 
 	// control for the change of direction depending on how much stock we are touching.  
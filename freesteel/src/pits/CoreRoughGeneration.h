@@ -24,6 +24,8 @@
 #include "bolts/I1.h"
 #include "cages/PathXSeries.h"
 #include "cages/Area2_gen.h"
+#include "cages/BoundXboxed.h"
+#include "pits/CircCrossingStructure.h"
 #include "pits/S2weaveCellLinearCut.h"
 #include <vector>
 
@@ -42,12 +44,19 @@ struct MachineParams
     double toolcornerrad;
     double toolflatrad;
     double samplestep;
+    double samplestepmax; // longest adaptive step, 0 to step by samplestep only
+    double samplechordtol; // deviation allowed from the turning arc in an adaptive step
     double stepdown;
     double clearcuspheight;
 
     // weave parameters
     double triangleweaveres;
     double flatradweaveres;
+    double weaverefinetol; // 0 for no refinement of the triangle weave
+    double weaveresmin;
+    double contoursimplifyfrac; // of the weave resolution, 0 for unsimplified contours
+    double areaoffsetres; // grid spacing of the distance field for the flat-rad offset, 0 to offset with discs
+    double zsweepband; // depth of surface each fibre keeps from level to level, 0 to search the boxes at each level
 
     // steering parameters
     double dchangright;
@@ -73,6 +82,8 @@ public:
 	I1 machyrg; 
 
 	PathXSeries tsbound; 
+	const BoundXboxed* ptsboundxb; // boxed tsbound for the circle intersections
+	CircEngagement engage; // what's near the last of them
 
 	Area2_gen* pa2gg; 	
 
@@ -32,35 +32,118 @@ void Ray_gen::HoldFibre(S1* lpfib, double lz)
 //////////////////////////////////////////////////////////////////////
 void Ray_gen::BallSlice(const P3& a)
 {
-    if (NormRay_gen::BallSlice(Transform(a)))
-        pfib->Merge(reslo, binterncellboundlo, reshi, binterncellboundhi);
+    if (pfib->ftype == S1::Fibre::u)
+        BallSliceF<S1::Fibre::u>(a);
+    else
+        BallSliceF<S1::Fibre::v>(a);
+}
+
+void Ray_gen::BallSlice(const P3& a, const P3& b)
+{
+    if (pfib->ftype == S1::Fibre::u)
+        BallSliceF<S1::Fibre::u>(a, b);
+    else
+        BallSliceF<S1::Fibre::v>(a, b);
+}
+
+void Ray_gen::BallSlice(const P3& a, const P3& b1, const P3& b2)
+{
+    if (pfib->ftype == S1::Fibre::u)
+        BallSliceF<S1::Fibre::u>(a, b1, b2);
+    else
+        BallSliceF<S1::Fibre::v>(a, b1, b2);
 }
 
 
+
 //////////////////////////////////////////////////////////////////////
-void Ray_gen::BallSlice(const P3& a, const P3& b)
+MultiRay_gen::MultiRay_gen(const std::vector<double>& lradballs, const I1& lwrg)
+ : rgens(), z()
 {
-    P3 ta = Transform(a);
-    P3 tb = Transform(b);
-    bool bres = (ta.z < tb.z ? NormRay_gen::BallSlice(ta, tb) : NormRay_gen::BallSlice(tb, ta));
-    if (bres)
-        pfib->Merge(reslo, binterncellboundlo, reshi, binterncellboundhi);
+	ASSERT(!lradballs.empty()); 
+	rgens.reserve(lradballs.size()); 
+	for (auto radball : lradballs)
+	{
+		ASSERT(rgens.empty() || (radball <= rgens.back().radball)); 
+		rgens.emplace_back(radball, lwrg); 
+	}
 }
 
+//////////////////////////////////////////////////////////////////////
+void MultiRay_gen::HoldFibres(const std::vector<S1*>& lpfibs, double lz)
+{
+	ASSERT(lpfibs.size() == rgens.size()); 
+	z = lz; 
+	for (std::size_t k = 0; k < rgens.size(); k++)
+	{
+		ASSERT((lpfibs[k]->ftype == lpfibs[0]->ftype) && (lpfibs[k]->wp == lpfibs[0]->wp)); 
+		rgens[k].HoldFibre(lpfibs[k], lz); 
+	}
+}
 
 //////////////////////////////////////////////////////////////////////
-void Ray_gen::BallSlice(const P3& a, const P3& b1, const P3& b2)
+// the height is in y for u fibres and x for v fibres.  
+// the ball of radius r takes up [-r, r] across and [z, z + 2r] in height, 
+// so once an element's box is clear of it, it's clear of all the smaller balls.  
+static bool BoxClear(bool bu, const I1& xrg, const I1& yrg, double z, double radball)
 {
-    P3 ta = Transform(a);
-    P3 tb1 = Transform(b1);
-    P3 tb2 = Transform(b2);
+	const I1& wrg = (bu ? xrg : yrg); 
+	const I1& hrg = (bu ? yrg : xrg); 
+	return ((wrg.lo > radball) || (wrg.hi < -radball) || (hrg.lo > z + 2 * radball) || (hrg.hi < z)); 
+}
 
-    // not quite saving the value I'd hoped here
-    P3 xprod = P3::CrossProd(tb1 - ta, tb2 - ta);
+// subtracted in the same order as Ray_gen::TransformF so the results are the same
+static P3 ShiftToBall(bool bu, const P3& t, double radball, double z)
+{
+	return (bu ? P3(t.x, t.y - radball - z, t.z) : P3(t.x - radball - z, t.y, t.z)); 
+}
+
+//////////////////////////////////////////////////////////////////////
+void MultiRay_gen::BallSliceN(bool bu, const P3& ta)
+{
+	for (auto& rgen : rgens)
+	{
+		if (BoxClear(bu, I1(ta.x, ta.x), I1(ta.y, ta.y), z, rgen.radball))
+			break; 
+		if (rgen.NormRay_gen::BallSlice(ShiftToBall(bu, ta, rgen.radball, z)))
+			rgen.pfib->Merge(rgen.reslo, rgen.binterncellboundlo, rgen.reshi, rgen.binterncellboundhi); 
+	}
+}
 
-    bool bres = (xprod.z >= 0.0 ? NormRay_gen::BallSlice(ta, tb1, tb2, xprod) : NormRay_gen::BallSlice(ta, tb2, tb1, -xprod));
-    if (bres)
-        pfib->Merge(reslo, binterncellboundlo, reshi, binterncellboundhi);
+//////////////////////////////////////////////////////////////////////
+void MultiRay_gen::BallSliceN(bool bu, const P3& ta, const P3& tb)
+{
+	I1 xrg = I1::SCombine(ta.x, tb.x); 
+	I1 yrg = I1::SCombine(ta.y, tb.y); 
+	for (auto& rgen : rgens)
+	{
+		if (BoxClear(bu, xrg, yrg, z, rgen.radball))
+			break; 
+		P3 rta = ShiftToBall(bu, ta, rgen.radball, z); 
+		P3 rtb = ShiftToBall(bu, tb, rgen.radball, z); 
+		bool bres = (rta.z < rtb.z ? rgen.NormRay_gen::BallSlice(rta, rtb) : rgen.NormRay_gen::BallSlice(rtb, rta)); 
+		if (bres)
+			rgen.pfib->Merge(rgen.reslo, rgen.binterncellboundlo, rgen.reshi, rgen.binterncellboundhi); 
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+void MultiRay_gen::BallSliceN(bool bu, const P3& ta, const P3& tb1, const P3& tb2)
+{
+	I1 xrg = I1::SCombine(ta.x, tb1.x, tb2.x); 
+	I1 yrg = I1::SCombine(ta.y, tb1.y, tb2.y); 
+	for (auto& rgen : rgens)
+	{
+		if (BoxClear(bu, xrg, yrg, z, rgen.radball))
+			break; 
+		P3 rta = ShiftToBall(bu, ta, rgen.radball, z); 
+		P3 rtb1 = ShiftToBall(bu, tb1, rgen.radball, z); 
+		P3 rtb2 = ShiftToBall(bu, tb2, rgen.radball, z); 
+		P3 xprod = P3::CrossProd(rtb1 - rta, rtb2 - rta); 
+		bool bres = (xprod.z >= 0.0 ? rgen.NormRay_gen::BallSlice(rta, rtb1, rtb2, xprod) : rgen.NormRay_gen::BallSlice(rta, rtb2, rtb1, -xprod)); 
+		if (bres)
+			rgen.pfib->Merge(rgen.reslo, rgen.binterncellboundlo, rgen.reshi, rgen.binterncellboundhi); 
+	}
 }
 
 
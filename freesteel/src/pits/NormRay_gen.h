@@ -75,13 +75,95 @@ public:
 
 	void HoldFibre(S1* lpfib, double lz); 
 
-	P3 Transform(const P3& p) 
-        { return (pfib->ftype == S1::Fibre::u ? P3(p.x - pfib->wp, p.z - radball - z, p.y) : P3(p.z - radball - z, p.y - pfib->wp, p.x)); }
+	// the F versions are for loops where the fibre orientation is fixed, 
+	// and the branch on it can be taken once outside.  
+	template<S1::Fibre ft> P3 TransformF(const P3& p) const
+        { return (ft == S1::Fibre::u ? P3(p.x - pfib->wp, p.z - radball - z, p.y) : P3(p.z - radball - z, p.y - pfib->wp, p.x)); }
+	P3 Transform(const P3& p) const
+        { return (pfib->ftype == S1::Fibre::u ? TransformF<S1::Fibre::u>(p) : TransformF<S1::Fibre::v>(p)); }
 
+	template<S1::Fibre ft> void BallSliceF(const P3& a); 
+	template<S1::Fibre ft> void BallSliceF(const P3& a, const P3& b); 
+	template<S1::Fibre ft> void BallSliceF(const P3& a, const P3& b1, const P3& b2); 
 
 	void BallSlice(const P3& a); 
 	void BallSlice(const P3& a, const P3& b); 
 	void BallSlice(const P3& a, const P3& b1, const P3& b2); 
 }; 
 
+
+//////////////////////////////////////////////////////////////////////
+// balls of several radii down the same fibre position in weaves of 
+// the same grid.  the points are transformed once for all of them, and 
+// an element whose box is clear of a ball is clear of all the smaller ones.  
+class MultiRay_gen
+{
+public: 
+	std::vector<Ray_gen> rgens; // in decreasing radius
+	double z; 
+
+	MultiRay_gen(const std::vector<double>& lradballs, const I1& lwrg); 
+
+	void HoldFibres(const std::vector<S1*>& lpfibs, double lz); 
+	double MaxRadius() const 
+		{ return rgens.front().radball; }
+
+	// as Ray_gen::TransformF before the height is shifted to the ball centre
+	template<S1::Fibre ft> P3 TransformF(const P3& p) const
+        { return (ft == S1::Fibre::u ? P3(p.x - rgens.front().pfib->wp, p.z, p.y) : P3(p.z, p.y - rgens.front().pfib->wp, p.x)); }
+
+	template<S1::Fibre ft> void BallSliceF(const P3& a); 
+	template<S1::Fibre ft> void BallSliceF(const P3& a, const P3& b); 
+	template<S1::Fibre ft> void BallSliceF(const P3& a, const P3& b1, const P3& b2); 
+
+private: 
+	void BallSliceN(bool bu, const P3& ta); 
+	void BallSliceN(bool bu, const P3& ta, const P3& tb); 
+	void BallSliceN(bool bu, const P3& ta, const P3& tb1, const P3& tb2); 
+}; 
+
+
+//////////////////////////////////////////////////////////////////////
+// kept in the header so the transform and merge go inline into the slicing loops
+template<S1::Fibre ft> inline void Ray_gen::BallSliceF(const P3& a)
+{
+    if (NormRay_gen::BallSlice(TransformF<ft>(a)))
+        pfib->Merge(reslo, binterncellboundlo, reshi, binterncellboundhi);
+}
+
+
+//////////////////////////////////////////////////////////////////////
+template<S1::Fibre ft> inline void Ray_gen::BallSliceF(const P3& a, const P3& b)
+{
+    P3 ta = TransformF<ft>(a);
+    P3 tb = TransformF<ft>(b);
+    bool bres = (ta.z < tb.z ? NormRay_gen::BallSlice(ta, tb) : NormRay_gen::BallSlice(tb, ta));
+    if (bres)
+        pfib->Merge(reslo, binterncellboundlo, reshi, binterncellboundhi);
+}
+
+
+//////////////////////////////////////////////////////////////////////
+template<S1::Fibre ft> inline void Ray_gen::BallSliceF(const P3& a, const P3& b1, const P3& b2)
+{
+    P3 ta = TransformF<ft>(a);
+    P3 tb1 = TransformF<ft>(b1);
+    P3 tb2 = TransformF<ft>(b2);
+
+    // not quite saving the value I'd hoped here
+    P3 xprod = P3::CrossProd(tb1 - ta, tb2 - ta);
+
+    bool bres = (xprod.z >= 0.0 ? NormRay_gen::BallSlice(ta, tb1, tb2, xprod) : NormRay_gen::BallSlice(ta, tb2, tb1, -xprod));
+    if (bres)
+        pfib->Merge(reslo, binterncellboundlo, reshi, binterncellboundhi);
+}
+
+//////////////////////////////////////////////////////////////////////
+template<S1::Fibre ft> inline void MultiRay_gen::BallSliceF(const P3& a)
+    { BallSliceN(ft == S1::Fibre::u, TransformF<ft>(a)); }
+template<S1::Fibre ft> inline void MultiRay_gen::BallSliceF(const P3& a, const P3& b)
+    { BallSliceN(ft == S1::Fibre::u, TransformF<ft>(a), TransformF<ft>(b)); }
+template<S1::Fibre ft> inline void MultiRay_gen::BallSliceF(const P3& a, const P3& b1, const P3& b2)
+    { BallSliceN(ft == S1::Fibre::u, TransformF<ft>(a), TransformF<ft>(b1), TransformF<ft>(b2)); }
+
 #endif
@@ -20,14 +20,12 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include "pits/S2weaveCell.h"
 #include "cages/S2weave.h"
+#include <algorithm>
 
 //////////////////////////////////////////////////////////////////////
 std::size_t FindCellParal(const std::vector<S1>& wfibs, double lw)
 {
-    std::size_t res;
-	for (res = 1; res < wfibs.size(); res++) 
-		if (wfibs[res].wp > lw) 
-			break; 
+    std::size_t res = std::max<std::size_t>(FindFibreIndex(wfibs, lw, true), 1);
 	ASSERT((wfibs[res - 1].wp <= lw) && (wfibs[res].wp > lw)); 
 	return res; 
 }
@@ -44,7 +42,7 @@ void S2weaveCell::FindCellIndex(const P2& lptc)
 
 	// rebuild the rest of the cell info
 	ConstructCellBounds(); 
-	CreateBoundList();
+	LoadBoundList();
 }
 
 
@@ -62,8 +60,7 @@ void S2weaveCell::ConstructCellBounds()
 	clurg.SetRan(pfulo->wp, pfuhi->wp); 
 	clvrg.SetRan(pfvlo->wp, pfvhi->wp); 
 
-    boundlist.clear();
-	bolistpairs.clear(); 
+    pcb = nullptr;
 }
 
 
@@ -129,7 +126,7 @@ void S2weaveCell::AdvanceCrossSide(int icn, const P2& cspt)
 
 	// rebuild the rest of the cell info
 	ConstructCellBounds(); 
-	CreateBoundList();
+	LoadBoundList();
 }
 
 
@@ -139,7 +136,7 @@ void S2weaveCell::AdvanceCrossSide(int icn, const P2& cspt)
 //////////////////////////////////////////////////////////////////////
 int S2weaveCell::GetBoundListPosition(std::size_t sic, const P2& ptb, bool bOnBoundOutside)
 {
-	if (boundlist.empty()) 
+	if (pcb->boundlist.empty()) 
 		return -1; 
     std::size_t res = 0;
 	bool bgoingup = ((sic & 2) == 0); 
@@ -148,34 +145,34 @@ int S2weaveCell::GetBoundListPosition(std::size_t sic, const P2& ptb, bool bOnBo
 	double wb = (binV ? ptb.v : ptb.u); 
 	ASSERT(GetSide(sic)->wp == (binV ? ptb.u : ptb.v)); 
 
-	for ( ; res < boundlist.size(); res++) 
+	for ( ; res < pcb->boundlist.size(); res++) 
 	{
-		if (boundlist[res].first == sic)
+		if (pcb->boundlist[res].first == sic)
 		{
 			// handle the coincident cases with warning and properly 
-			if (boundlist[res].second->w == wb) 
+			if (pcb->boundlist[res].second->w == wb) 
 			{
 				ASSERT(bOnBoundOutside); 
 				if (!GetBoundLower(res)) 
 				{
 					res++; 
-					if (res == boundlist.size()) 
+					if (res == pcb->boundlist.size()) 
 						res = 0; 
 				}
 				else
 					ASSERT(1); // rare case of doubling back from a corner through the previous cell, which we must see.  
 				return res; 
 			}
-			if (bgoingup ? (boundlist[res].second->w >= wb) : (boundlist[res].second->w <= wb))  
+			if (bgoingup ? (pcb->boundlist[res].second->w >= wb) : (pcb->boundlist[res].second->w <= wb))  
 			{
 				ASSERT(!bOnBoundOutside); 
 				return res; 
 			}
 		}
-		else if (boundlist[res].first > sic)
+		else if (pcb->boundlist[res].first > sic)
 			break; 
 	}
-	if (res == boundlist.size()) 
+	if (res == pcb->boundlist.size()) 
 		res = 0; 
 	ASSERT(!bOnBoundOutside); 
 	return res; 
@@ -185,9 +182,9 @@ int S2weaveCell::GetBoundListPosition(std::size_t sic, const P2& ptb, bool bOnBo
 //////////////////////////////////////////////////////////////////////
 P2 S2weaveCell::GetBoundPoint(std::size_t ibl)
 {
-	bool binV = ((boundlist[ibl].first & 1) == 0); 
-	double wb = boundlist[ibl].second->w; 
-	double wp = GetSide(boundlist[ibl].first)->wp; 
+	bool binV = ((pcb->boundlist[ibl].first & 1) == 0); 
+	double wb = pcb->boundlist[ibl].second->w; 
+	double wp = GetSide(pcb->boundlist[ibl].first)->wp; 
 	return (binV ? P2(wp, wb) : P2(wb, wp)); 
 }
 
@@ -196,7 +193,7 @@ P2 S2weaveCell::GetBoundPoint(std::size_t ibl)
 bool S2weaveCell::GetBoundLower(std::size_t ibl)
 {
 	// this takes account of the sides 2 and 3 going in reverse.  
-	return (((boundlist[ibl].first & 2) == 0) == boundlist[ibl].second->blower); 
+	return (((pcb->boundlist[ibl].first & 2) == 0) == pcb->boundlist[ibl].second->blower); 
 }
 
 
@@ -204,9 +201,24 @@ bool S2weaveCell::GetBoundLower(std::size_t ibl)
 
 
 
+//////////////////////////////////////////////////////////////////////
+B1c& S2weaveCell::GetBoundB1c(std::size_t ibl)
+{
+	std::size_t sic = pcb->boundlist[ibl].first; 
+	bool bufib = ((sic & 1) == 0); 
+	std::size_t ixwp = (bufib ? ((sic & 2) == 0 ? iu - 1 : iu) : ((sic & 2) == 0 ? iv : iv - 1)); 
+	const S1* pfib = GetSide(sic); 
+	ASSERT(pfib == &(bufib ? ps2w->ufibs : ps2w->vfibs)[ixwp]); 
+	return ps2w->GetB1c(bufib, ixwp, pcb->boundlist[ibl].second - pfib->ep.data()); 
+}
+
+
+
+
+
 //////////////////////////////////////////////////////////////////////
 // we have some const_casts here so we can get at the 
-static bool AddBoundListMatches(std::vector< std::pair<std::size_t, B1*> >& boundlist, const S1& fw, const I1& rg, std::size_t edgno, bool bGoingDown, bool bStartIn)
+static bool AddBoundListMatches(std::vector< std::pair<std::size_t, const B1*> >& boundlist, const S1& fw, const I1& rg, std::size_t edgno, bool bGoingDown, bool bStartIn)
 {
     ASSERT(((edgno & 2) != 0) == bGoingDown);
     auto ilr = fw.Loclohi(rg);
@@ -230,7 +242,7 @@ static bool AddBoundListMatches(std::vector< std::pair<std::size_t, B1*> >& boun
     {
         for (auto i = ilr.first; i <= ilr.second; i++)
         {
-            boundlist.emplace_back(edgno, const_cast<B1*>(&(fw.ep[i])));
+            boundlist.emplace_back(edgno, &(fw.ep[i]));
             ASSERT(rg.Contains(fw.ep[i].w));
         }
     }
@@ -238,7 +250,7 @@ static bool AddBoundListMatches(std::vector< std::pair<std::size_t, B1*> >& boun
     {
         for (auto i = ilr.second; i >= ilr.first; i--)
         {
-            boundlist.emplace_back(edgno, const_cast<B1*>(&(fw.ep[i])));
+            boundlist.emplace_back(edgno, &(fw.ep[i]));
             ASSERT(rg.Contains(fw.ep[i].w));
         }
     }
@@ -247,37 +259,71 @@ static bool AddBoundListMatches(std::vector< std::pair<std::size_t, B1*> >& boun
 }
 
 //////////////////////////////////////////////////////////////////////
-std::size_t S2weaveCell::CreateBoundList()
+// into cb, which pcb points at.  
+std::size_t S2weaveCell::CreateBoundList(S2weaveCellBounds& cb)
 {
-    ASSERT(boundlist.empty());
-    ASSERT(bolistpairs.empty());
+    ASSERT(pcb == &cb);
+    cb.boundlist.clear();
+    cb.bolistpairs.clear();
 
     DEBUG_ONLY(bLDin = pfvlo->Contains(clurg.lo)); // final parameter only used for debug checking.
-    bLUin = AddBoundListMatches(boundlist, *pfulo, clvrg, 0, false, bLDin);
-    bRUin = AddBoundListMatches(boundlist, *pfvhi, clurg, 1, false, bLUin);
-    bRDin = AddBoundListMatches(boundlist, *pfuhi, clvrg, 2, true, bRUin);
-    bLDin = AddBoundListMatches(boundlist, *pfvlo, clurg, 3, true, bRDin);
+    bLUin = AddBoundListMatches(cb.boundlist, *pfulo, clvrg, 0, false, bLDin);
+    bRUin = AddBoundListMatches(cb.boundlist, *pfvhi, clurg, 1, false, bLUin);
+    bRDin = AddBoundListMatches(cb.boundlist, *pfuhi, clvrg, 2, true, bRUin);
+    bLDin = AddBoundListMatches(cb.boundlist, *pfvlo, clurg, 3, true, bRDin);
     
 
 	// for now, default resolve ambiguities, keeping the inside region connected.  
 	// (not as likely if there has been a flat-rad offset where the region will always have some radius, but the spaces may be narrow).  
 	DEBUG_ONLY(bool binD = bLDin); 
-    std::size_t ib = boundlist.size() - 1;
-    for (std::size_t ibl = 0; ibl < boundlist.size(); ibl++)
+    std::size_t ib = cb.boundlist.size() - 1;
+    for (std::size_t ibl = 0; ibl < cb.boundlist.size(); ibl++)
 	{
 		ASSERT(binD == !GetBoundLower(ibl)); 
 		if (GetBoundLower(ibl)) 
 		{
 			ASSERT(!GetBoundLower(ib)); 
-            bolistpairs.emplace_back(ib, ibl);
+            cb.bolistpairs.emplace_back(ib, ibl);
 		}
 		ib = ibl; 
 		DEBUG_ONLY(binD = !binD); 
 	}
 	ASSERT(binD == bLDin); 
-	ASSERT(bolistpairs.size() * 2 == boundlist.size()); 
-
-    return bolistpairs.size();
+	ASSERT(cb.bolistpairs.size() * 2 == cb.boundlist.size()); 
+
+    cb.bLDin = bLDin;
+    cb.bLUin = bLUin;
+    cb.bRUin = bRUin;
+    cb.bRDin = bRDin;
+    for (int icn = 0; icn < 4; icn++)
+        cb.sidenwrites[icn] = GetSide(icn)->ep.Nwrites();
+    return cb.bolistpairs.size();
 }
 
 
+
+//////////////////////////////////////////////////////////////////////
+// the traversals go back and forth over the same cells, 
+// so the lists are only made the first time round.  
+std::size_t S2weaveCell::LoadBoundList()
+{
+    bool bnew;
+    S2weaveCellBounds& cb = ps2w->GetCellBounds(iu, iv, bnew);
+    pcb = &cb;
+
+    // fibres written without a Changed() would leave pointers to stale endpoints.  
+    bool bstale = false;
+    for (int icn = 0; icn < 4; icn++)
+        bstale = bstale || (cb.sidenwrites[icn] != GetSide(icn)->ep.Nwrites());
+    ASSERT(bnew || !bstale);
+
+    if (bnew || bstale)
+        return CreateBoundList(cb);
+
+    bLDin = cb.bLDin;
+    bLUin = cb.bLUin;
+    bRUin = cb.bRUin;
+    bRDin = cb.bRDin;
+    return cb.bolistpairs.size();
+}
+
@@ -22,6 +22,7 @@
 #ifndef S2WEAVECELL_H
 #define S2WEAVECELL_H
 #include "bolts/S1.h"
+#include "cages/S2weave.h"
 #include "bolts/I1.h"
 #include "bolts/P2.h"
 #include <vector>
@@ -53,27 +54,28 @@ struct S2weaveCell
 	P2 GetCorner(int icn) const; 
 	const S1* GetSide(int icn) const; // gets the following edge from the corner.  
 
-    // the list of endpoints of fibres in this cell.
+    // the lists of this cell, held in the weave's cache.  
+    // boundlist is the endpoints of fibres in this cell, 
     // first int is the edge (left is first), second is the B1 entry in the array.
-    std::vector< std::pair<std::size_t, B1*> > boundlist;
+	// bolistpairs index into boundlist and connect the 
+	// points between the boundary with lines, resolving ambiguities.  
+	// not possible to control for order.  
+    const S2weaveCellBounds* pcb;
     bool bLDin;
     bool bLUin;
     bool bRUin;
     bool bRDin;
 
-	// index into boundlist which marks connects the 
-	// points between the boundary with lines, resolving ambiguities.  
-	// not possible to control for order.  
-    std::vector< std::pair<std::size_t, std::size_t> > bolistpairs;
-
 
     P2 GetBoundPoint(std::size_t ibl);
     bool GetBoundLower(std::size_t ibl);
+    B1c& GetBoundB1c(std::size_t ibl); // contour and cut state of the endpoint, held in the weave.
 
 
 	// changing and construction functions 
 		void ConstructCellBounds(); 
-        std::size_t CreateBoundList();
+        std::size_t CreateBoundList(S2weaveCellBounds& cb);
+        std::size_t LoadBoundList(); // CreateBoundList through the cache in the weave.
 	void FindCellIndex(const P2& lptc); 
 	void AdvanceCrossSide(int icn, const P2& cspt); 
 
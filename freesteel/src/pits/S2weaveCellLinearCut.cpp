@@ -145,7 +145,7 @@ void S2weaveCellLinearCut::AdvanceThroughForeCut(bool bOnBoundF)
 double S2weaveCellLinearCut::Getbolistcrossing(double& lambb, P2& ptcross, int ibb)  
 {
 	int ib = bolistcrossings[ibb].first; 
-    auto ibp = bolistpairs[ib];
+    auto ibp = pcb->bolistpairs[ib];
 	double lamc0 = Dot(apvb, GetBoundPoint(ibp.first)); 
 	double lamc1 = Dot(apvb, GetBoundPoint(ibp.second)); 
 	ASSERT(bolistcrossings[ibb].second ? ((lamc0 >= ptcDapvb) && (lamc1 <= ptcDapvb)) : ((lamc0 <= ptcDapvb) && (lamc1 >= ptcDapvb))); 
@@ -175,7 +175,7 @@ void S2weaveCellLinearCut::FindBolistCrossings()
 	// put into the debug area.  
 
 	ASSERT(bolistcrossings.empty()); 
-	if (bolistpairs.empty()) 
+	if (pcb->bolistpairs.empty()) 
 		return; 
 
 	// everything is on one side of the line, so no 
@@ -205,12 +205,12 @@ void S2weaveCellLinearCut::FindBolistCrossings()
 		bool bDownCut = GetBoundLower(ib); 
 
 		// find other end of the cut 
-        std::ptrdiff_t i = bolistpairs.size() - 1;
+        std::ptrdiff_t i = pcb->bolistpairs.size() - 1;
 		for ( ; i >= 0; i--) 
-			if ((bDownCut ? bolistpairs[i].second : bolistpairs[i].first) == ib) 
+			if ((bDownCut ? pcb->bolistpairs[i].second : pcb->bolistpairs[i].first) == ib) 
 				break; 
 		ASSERT(i >= 0); 
-        auto ibth = (bDownCut ? bolistpairs[i].first : bolistpairs[i].second);
+        auto ibth = (bDownCut ? pcb->bolistpairs[i].first : pcb->bolistpairs[i].second);
 		
 		// we have other end.  Is this a crossing or a loop on this side?  
 		bool bloopcut; 
@@ -243,17 +243,17 @@ void S2weaveCellLinearCut::FindBolistCrossings()
 			#ifdef MDEBUG
 			ASSERT((Dlamc0 <= ptcDapvb) && (Dlamc1 <= ptcDapvb)); 
 			int Dlib = ib + 1; 
-			if (Dlib == boundlist.size()) 
+			if (Dlib == pcb->boundlist.size()) 
 				Dlib = 0; 
 			while (Dlib != ibth) 
 			{
 				bool DlbDownCut = GetBoundLower(Dlib); 
-				int Dli = bolistpairs.size() - 1; 
+				int Dli = pcb->bolistpairs.size() - 1; 
 				for ( ; Dli >= 0; i--) 
-					if ((DlbDownCut ? bolistpairs[Dli].second : bolistpairs[Dli].first) == Dlib) 
+					if ((DlbDownCut ? pcb->bolistpairs[Dli].second : pcb->bolistpairs[Dli].first) == Dlib) 
 						break; 
 				ASSERT(Dli >= 0); 
-                auto Dlibth = (bDownCut ? bolistpairs[Dli].first : bolistpairs[Dli].second);
+                auto Dlibth = (bDownCut ? pcb->bolistpairs[Dli].first : pcb->bolistpairs[Dli].second);
 				if (ib < ibth) 
 					ASSERT((Dlibth > ib) && (Dlibth < ib)); 
 				else
@@ -261,7 +261,7 @@ void S2weaveCellLinearCut::FindBolistCrossings()
 
 				// advance to next boundlist element.  
 				Dlib++; 
-				if (Dlib == boundlist.size()) 
+				if (Dlib == pcb->boundlist.size()) 
 					Dlib = 0; 
 			}
 			#endif
@@ -293,7 +293,7 @@ void S2weaveCellLinearCut::FindBolistCrossings()
 
 		// advance to next boundlist element.  
 		ib++; 
-		if (ib == boundlist.size()) 
+		if (ib == pcb->boundlist.size()) 
 			ib = 0; 
 	}
 
@@ -20,6 +20,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include "pits/S2weaveCellLinearCut.h"
 #include "bolts/smallfuncs.h"
+#include "cages/S2weave.h"
 
 //////////////////////////////////////////////////////////////////////
 void S2weaveCellLinearCutTraverse::Findibbfore(std::size_t libb)
@@ -97,7 +98,7 @@ bool S2weaveCellLinearCutTraverse::SetCellCutContinue(const P2& lvbearing)
 	{
 		// the going out case is then we we are on the bound on the 
 		// edge of a cell, and are heading back across the cell boundary.  
-        auto sic = (lambb == 0.0 ? boundlist[bolistpairs[ib].first].first : boundlist[bolistpairs[ib].second].first);
+        auto sic = (lambb == 0.0 ? pcb->boundlist[pcb->bolistpairs[ib].first].first : pcb->boundlist[pcb->bolistpairs[ib].second].first);
 		if (VecBearingInwardCell(sic, lvbearing)) 
 			bOnBoundB = true; 
 		else
@@ -141,7 +142,7 @@ bool S2weaveCellLinearCutTraverse::SetCellCutContinue(const P2& lvbearing)
 					break; 
 			ASSERT(libb < bolistcrossings.size()); 
 			#ifdef MDEBUG
-            auto ccrD = bolistpairs[bolistcrossings[libb].first];
+            auto ccrD = pcb->bolistpairs[bolistcrossings[libb].first];
 			TOL_ZERO((Along(lambb, GetBoundPoint(ccrD.first), GetBoundPoint(ccrD.second)) - ptcpbb).Len()); 
 			#endif
 
@@ -164,7 +165,7 @@ bool S2weaveCellLinearCutTraverse::SetCellCutContinue(const P2& lvbearing)
 	#ifdef MDEBUG
 	if (ibb != -1) 
 	{
-        auto ccrD = bolistpairs[bolistcrossings[ibb].first];
+        auto ccrD = pcb->bolistpairs[bolistcrossings[ibb].first];
 		TOL_ZERO((Along(lambb, GetBoundPoint(ccrD.first), GetBoundPoint(ccrD.second)) - ptcpbb).Len()); 
 	}
 	#endif
@@ -234,7 +235,7 @@ void S2weaveCellLinearCutTraverse::AdvanceToContourCut()
 	bContouribfvisited = false; // we join in the middle.  
 
 	TOL_ZERO((ptcst + vbearing * lamcp - ptcp).Len()); 
-    auto ccr = bolistpairs[ib];
+    auto ccr = pcb->bolistpairs[ib];
 	TOL_ZERO((Along(lambb, GetBoundPoint(ccr.first), GetBoundPoint(ccr.second)) - ptcp).Len()); 
 
 	// set the bearing now 
@@ -251,7 +252,7 @@ void S2weaveCellLinearCutTraverse::AdvanceAlongContourToLamPos(double llambn)
 	ASSERT(bOnContour); 
 	ASSERT(bolistcrossings.empty()); 
 	ASSERT(I1(lambb, 1.0).Contains(llambn)); 
-    auto ccr = bolistpairs[ib];
+    auto ccr = pcb->bolistpairs[ib];
 	TOL_ZERO((Along(lambb, GetBoundPoint(ccr.first), GetBoundPoint(ccr.second)) - ptcpbb).Len()); 
 	
 	lambb = llambn; 
@@ -266,39 +267,37 @@ void S2weaveCellLinearCutTraverse::AdvanceAlongContourAcrossCell()
 	ASSERT(bOnContour); 
 	ASSERT(bolistcrossings.empty()); 
 	#ifdef MDEBUG
-    auto ccrD = bolistpairs[ib];
+    auto ccrD = pcb->bolistpairs[ib];
 	TOL_ZERO((Along(lambb, GetBoundPoint(ccrD.first), GetBoundPoint(ccrD.second)) - ptcpbb).Len()); 
 	#endif
 
 
-    auto ibl = bolistpairs[ib].second;
+    auto ibl = pcb->bolistpairs[ib].second;
 	ptcpbb = GetBoundPoint(ibl); 
 	ptcp = ptcpbb; 
 	ASSERT(GetBoundLower(ibl)); 
 	lambb = 0.0; 
 
 	// cross over into the next cell 
-	int sicc = boundlist[ibl].first; 
-	const B1* blcp = boundlist[ibl].second; 
+	int sicc = pcb->boundlist[ibl].first; 
+	const B1* blcp = pcb->boundlist[ibl].second; 
 
-	boundlist.clear(); 
-	bolistpairs.clear(); 
 	AdvanceCrossSide(sicc, ptcpbb); 
 
 	// find the point in the boundlist which matches the one we are crossing over on.  
-	for (ibl = 0; ibl < boundlist.size(); ibl++) 
-		if (boundlist[ibl].second == blcp) 
+	for (ibl = 0; ibl < pcb->boundlist.size(); ibl++) 
+		if (pcb->boundlist[ibl].second == blcp) 
 			break; 
-	ASSERT(ibl < boundlist.size()); 
-	ASSERT(boundlist[ibl].first == ((sicc + 2) & 3)); 
+	ASSERT(ibl < pcb->boundlist.size()); 
+	ASSERT(pcb->boundlist[ibl].first == ((sicc + 2) & 3)); 
 
 	// find the pair which leads on from this point 
-	for (ib = 0; ib < bolistpairs.size(); ib++) 
-		if (bolistpairs[ib].first == ibl) 
+	for (ib = 0; ib < pcb->bolistpairs.size(); ib++) 
+		if (pcb->bolistpairs[ib].first == ibl) 
 			break; 
-	ASSERT(ib < bolistpairs.size()); 
+	ASSERT(ib < pcb->bolistpairs.size()); 
 
-	ASSERT(ptcpbb == GetBoundPoint(bolistpairs[ib].first)); 
+	ASSERT(ptcpbb == GetBoundPoint(pcb->bolistpairs[ib].first)); 
 	// iblb will be set properly on the peeling off.  
 }
 
@@ -315,7 +314,7 @@ bool S2weaveCellLinearCutTraverse::OnContourFollowBearing(double dch, double fol
 	// if we're on contour, decide whether to stick with it.  
 	ASSERT(bOnContour); 
 
-    auto ccr = bolistpairs[ib];
+    auto ccr = pcb->bolistpairs[ib];
 	P2 vnl = GetBoundPoint(ccr.second) - GetBoundPoint(ccr.first); 
 
 	// choose to leave the contour because we're not pushed in.  
@@ -339,10 +338,10 @@ bool S2weaveCellLinearCutTraverse::OnContourFollowBearing(double dch, double fol
 		// we will cross this cell boundary.  Mark it if it's entirely cleared from the start.  
 		if (bContouribfvisited) 
 		{
-            auto ibl = bolistpairs[ib].second;
+            auto ibl = pcb->bolistpairs[ib].second;
 			ASSERT(GetBoundLower(ibl)); 
-			ASSERT(boundlist[ibl].second->cutcode == -1); 
-			boundlist[ibl].second->cutcode = 0; 
+			ASSERT(!ps2w->IsCut(GetBoundB1c(ibl))); 
+			ps2w->SetCut(GetBoundB1c(ibl)); 
 		}
 		AdvanceAlongContourAcrossCell(); 
 
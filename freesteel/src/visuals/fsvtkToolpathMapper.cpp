@@ -89,6 +89,19 @@ int fsvtkToolpathMapper::Draw(vtkRenderer *aren, vtkActor *act)
         return DrawPathSegment(); 
 }
 
+/////////////////////////////////////////////////////////////////////////////////
+// the move into link point ilp, with arcs drawn in short chords.  
+static void LinkVertices(const std::vector<P3>& lnkpth, const std::vector<ArcX>& lnkarcs, int ilp)
+{
+	int n = (lnkarcs.empty() || (lnkarcs[ilp].dir == 0) ? 1 : 16);
+	for (int k = 1; k < n; ++k)
+	{
+		P3 pt = LinkAlong((double)k / n, lnkpth, lnkarcs, ilp);
+		glVertex3d(pt.x, pt.y, pt.z);
+	}
+	glVertex3d(lnkpth[ilp].x, lnkpth[ilp].y, lnkpth[ilp].z);
+}
+
 /////////////////////////////////////////////////////////////////////////////////
 // draw from last drawn toolpath(lxp), last drawn segment(lxs), up to last point
 // (lptpath) to path ixp, segment ixs, point pt;
@@ -146,8 +159,9 @@ int fsvtkToolpathMapper::DrawPathSegment()
 			if (!lnkpth.empty())
 			{
 				glBegin(GL_LINE_STRIP);
-				for (int ilp = 0; ilp < lnkpth.size(); ++ilp)
-					glVertex3d(lnkpth[ilp].x, lnkpth[ilp].y, lnkpth[ilp].z);	
+				glVertex3d(lnkpth[0].x, lnkpth[0].y, lnkpth[0].z);	
+				for (int ilp = 1; ilp < lnkpth.size(); ++ilp)
+					LinkVertices(lnkpth, pathxs.linkarcs[jl], ilp);
 				glEnd();
 			}
 		}
@@ -158,8 +172,10 @@ int fsvtkToolpathMapper::DrawPathSegment()
 			{
 				glBegin(GL_LINE_STRIP);
 				ASSERT(pos.isegOnLink <= lnkpth.size());
-				for (int ilp = 0; ilp < pos.isegOnLink; ++ilp)
-					glVertex3d(lnkpth[ilp].x, lnkpth[ilp].y, lnkpth[ilp].z);	
+				if (pos.isegOnLink > 0)
+					glVertex3d(lnkpth[0].x, lnkpth[0].y, lnkpth[0].z);	
+				for (int ilp = 1; ilp < pos.isegOnLink; ++ilp)
+					LinkVertices(lnkpth, pathxs.linkarcs[pos.ilink], ilp);
 				glVertex3d(pos.ptOnLink.x, pos.ptOnLink.y, pos.ptOnLink.z);	
 				glEnd();
 			}
@@ -199,7 +215,7 @@ void fsvtkToolpathMapper::CalculateStock(double zstock)
 	for (int ix = 0; ix < pos.ipathx; ++ix)
 	{
 		const PathXSeries& pathxs = (*pftpaths)[ix];
-		HackToolpath(stockweave, pathxs, pathxs.pths.size(), P2(), rad); 
+		HackToolpath(*stockweave, pathxs, 0, pathxs.pths.size(), rad); 
 	}
 	*/ 
 	
@@ -44,6 +44,9 @@
 static char *cformat = "LX%.3fY%.3fZ%.3fF%d\n";
 static char *cformatNoF = "LX%.3fY%.3fZ%.3f\n";
 static char *cformatNoFZ = "LX%.3fY%.3f\n";
+static char *cformatCC = "CCX%.3fY%.3f\n";
+static char *cformatC = "CX%.3fY%.3fDR%c\n";
+static char *cformatCP = "CPIPA%+.3fIZ%+.3fDR%c\n";
 
 class ThinAlg
 {
@@ -103,7 +106,27 @@ public:
 	}
 };
 
-bool Advance(AnimatedPos& res, const std::vector<P2>& pths, const std::vector< std::vector<P3> >& links, const std::vector<std::size_t>& brks, double z, double adv, double& advanced, FILE* fn = NULL, int fcut = -1, int fretract = -1, double tol = 0.0)
+// lines, or arcs given by their centre first.  
+// a helix can only be given in polar form, by its signed sweep in degrees and its rise.  
+static void PostLinkMove(FILE* fn, const P3& ptfrom, const P3& pt, const ArcX& arc)
+{
+	if (arc.dir == 0)
+		fprintf(fn,	cformatNoF, pt.x, pt.y, pt.z);
+	else
+	{
+		char cdr = (arc.dir == 1 ? '+' : '-'); 
+		fprintf(fn,	cformatCC, arc.cen.u, arc.cen.v);
+		if (pt.z == ptfrom.z)
+			fprintf(fn,	cformatC, pt.x, pt.y, cdr);
+		else
+		{
+			double ipa = arc.dir * arc.Sweep(P2(ptfrom.x, ptfrom.y), P2(pt.x, pt.y)) * 180.0 / MPI; 
+			fprintf(fn,	cformatCP, ipa, pt.z - ptfrom.z, cdr);
+		}
+	}
+}
+
+bool Advance(AnimatedPos& res, const std::vector<P2>& pths, const std::vector< std::vector<P3> >& links, const std::vector< std::vector<ArcX> >& linkarcs, const std::vector<std::size_t>& brks, double z, double adv, double& advanced, FILE* fn = NULL, int fcut = -1, int fretract = -1, double tol = 0.0)
 {
     advanced = 0;
 	res.ilink = -1;
@@ -159,13 +182,13 @@ bool Advance(AnimatedPos& res, const std::vector<P2>& pths, const std::vector< s
 				}
 				for (int il = 1; il < link.size(); ++il) 
 				{
-					double lenseg = (link[il] - link[il - 1]).Len();
+					double lenseg = LinkSegLen(link, linkarcs[j], il);
 					if ((adv >= 0) && (adv - lenseg) <= 0.0)
 					{
 						// stop along this segment
 						advanced += adv;
 						res.isegOnLink = il;
-						res.ptOnLink = Along((adv /	lenseg), link[il - 1], link[il]);
+						res.ptOnLink = LinkAlong((adv / lenseg), link, linkarcs[j], il);
 						res.bOnPath = false;
 						return false;
 					}
@@ -175,7 +198,7 @@ bool Advance(AnimatedPos& res, const std::vector<P2>& pths, const std::vector< s
 					res.ptOnLink = link[il];
 					res.isegOnLink = il;
 					if (fn)
-						fprintf(fn,	cformatNoF, res.ptOnLink.x, res.ptOnLink.y, res.ptOnLink.z);
+						PostLinkMove(fn, link[il - 1], res.ptOnLink, (linkarcs[j].empty() ? ArcX() : linkarcs[j][il]));
 				}
 				res.isegOnLink = link.size();
 				if (!link.empty())
@@ -197,13 +220,13 @@ bool Advance(AnimatedPos& res, const std::vector<P2>& pths, const std::vector< s
 		}
 		for (int il = 1; il < link.size(); ++il) 
 		{
-			double lenseg = (link[il] - link[il - 1]).Len();
+			double lenseg = LinkSegLen(link, linkarcs[j], il);
 			if ((adv >= 0) && (adv - lenseg) <= 0.0)
 			{
 				// stop along this segment
 				advanced += adv;
 				res.isegOnLink = il;
-				res.ptOnLink = Along((adv /	lenseg), link[il - 1], link[il]);
+				res.ptOnLink = LinkAlong((adv / lenseg), link, linkarcs[j], il);
 				res.bOnPath = false;
 				return false;
 			}
@@ -213,7 +236,7 @@ bool Advance(AnimatedPos& res, const std::vector<P2>& pths, const std::vector< s
 			res.ptOnLink = link[il];
 			res.isegOnLink = il;
 			if (fn)
-				fprintf(fn,	cformatNoF, res.ptOnLink.x, res.ptOnLink.y, res.ptOnLink.z);
+				PostLinkMove(fn, link[il - 1], res.ptOnLink, (linkarcs[j].empty() ? ArcX() : linkarcs[j][il]));
 		}
 		res.isegOnLink = link.size();
 		if (!link.empty())
@@ -231,7 +254,7 @@ void PostProcess(FILE* file, const std::vector<PathXSeries>& pathxseries, const
     for (const auto& pathxs : pathxseries)
 	{
 		double levellen = 0;
-		Advance(pos, pathxs.pths, pathxs.linkpths, pathxs.brks, pathxs.z, -1.0, levellen, file, params.fcut, params.fretract, params.thintol);
+		Advance(pos, pathxs.pths, pathxs.linkpths, pathxs.linkarcs, pathxs.brks, pathxs.z, -1.0, levellen, file, params.fcut, params.fretract, params.thintol);
 	}
 }
 
@@ -328,7 +351,7 @@ void AnimationFrame::OnAnimateTP(wxScrollEvent& event)
             for (; ip < pthanimated->ftpaths.size(); ++ip)
             {
                 PathXSeries& pathxs = pthanimated->ftpaths[ip];
-                bool bFinish = Advance(pthanimated->ftpolydataMap->pos, pathxs.pths, pathxs.linkpths, pathxs.brks, pathxs.z, animatedlength, advanced);
+                bool bFinish = Advance(pthanimated->ftpolydataMap->pos, pathxs.pths, pathxs.linkpths, pathxs.linkarcs, pathxs.brks, pathxs.z, animatedlength, advanced);
                 animatedlength -= advanced;
                 if (!bFinish)
                 {
@@ -378,7 +401,7 @@ void AnimationFrame::SetAnimated(class GSTtoolpath* gst)
 	{
 		double levellen = 0;
 		const PathXSeries& pathxs = pthanimated->ftpaths[ip];
-		Advance(pthanimated->ftpolydataMap->pos, pathxs.pths, pathxs.linkpths, pathxs.brks, pathxs.z, -1.0, levellen);
+		Advance(pthanimated->ftpolydataMap->pos, pathxs.pths, pathxs.linkpths, pathxs.linkarcs, pathxs.brks, pathxs.z, -1.0, levellen);
 		totallen += levellen;            
 	}
 	pthanimated->ftpolydataMap->pos.ipathx = pthanimated->ftpaths.size() - 1;
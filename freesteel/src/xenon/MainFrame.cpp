@@ -379,12 +379,19 @@ void MainFrame::OnMachiningAreaclear(wxCommandEvent& WXUNUSED(event) )
 		params.toolcornerrad = cr;
 		params.toolflatrad = fr;
 		params.samplestep = 0.4;
+		params.samplestepmax = 0.0; 
+		params.samplechordtol = 0.01; 
 		params.stepdown = sd;
 		params.clearcuspheight = sd / 3.0;
 
 	// weave parameters
 		params.triangleweaveres = 0.51;
 		params.flatradweaveres = 0.71;
+		params.weaverefinetol = 0.0; 
+		params.weaveresmin = 0.1; 
+		params.contoursimplifyfrac = 0.0; 
+		params.areaoffsetres = 0.0; 
+		params.zsweepband = sd * 2; 
 
 	// stearing parameters
 	// fixed values controlling the step-forward of the tool and 